@@ -1,7 +1,9 @@
 #include "ActionInitialization.hh"
 
+#include "EventAction.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "RunAction.hh"
+#include "StackingAction.hh"
 #include "SteppingAction.hh"
 #include "TrackingAction.hh"
 #include "G4RunManager.hh"
@@ -33,10 +35,18 @@ void ActionInitialization::Build() const
             FatalException, "DetectorConstruction cast failed!");
     }
 
-    // 4. SteppingAction (MUST use correct constructor)
-    SteppingAction* stepping = new SteppingAction(runAction, detConst);
+    // 4. EventAction (per-event results)
+    auto eventAction = new EventAction();
+    SetUserAction(eventAction);
+
+    // 5. SteppingAction (MUST use correct constructor)
+    SteppingAction* stepping =
+        new SteppingAction(runAction, detConst, eventAction);
     SetUserAction(stepping);
 
-    // 5. TrackingAction
+    // 6. TrackingAction
     SetUserAction(new TrackingAction());
+
+    // 7. StackingAction (drops optical photons when folding a response)
+    SetUserAction(new StackingAction());
 }
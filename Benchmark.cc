@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/Benchmark.cc
+/// \brief Implementation of the Benchmark class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Benchmark.hh"
+
+#include "G4RunManager.hh"
+#include "G4Version.hh"
+
+#include <fstream>
+#include <iomanip>
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+Benchmark* Benchmark::Instance()
+{
+  static Benchmark instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+Benchmark::Benchmark()
+  : fStart(Clock::now())
+  , fRunStart(fStart)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Benchmark::BeginOfRun()
+{
+  fRunStart = Clock::now();
+  if(fInitTime < 0.)
+    fInitTime = std::chrono::duration<G4double>(fRunStart - fStart).count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Benchmark::EndOfRun(G4int events, std::uint64_t opticalSteps,
+                         std::uint64_t opticalPhotons) const
+{
+  if(!IsActive())
+    return;
+
+  G4double wall =
+    std::chrono::duration<G4double>(Clock::now() - fRunStart).count();
+  G4double rate  = wall > 0. ? 1. / wall : 0.;
+  G4int threads  = G4RunManager::GetRunManager()->GetNumberOfThreads();
+  G4double rss   = GetPeakRSS();
+
+  std::ofstream out(fFile, std::ios::app);
+  if(!out)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open " << fFile << " for writing.";
+    G4Exception("Benchmark::EndOfRun", "OpNovice2_013", JustWarning, ed);
+    return;
+  }
+  // one self-contained record per line (JSON Lines)
+  out << std::setprecision(6) << "{\"label\": \"" << fLabel
+      << "\", \"geant4\": " << G4VERSION_NUMBER
+      << ", \"threads\": " << threads << ", \"events\": " << events
+      << ", \"optical_steps\": " << opticalSteps
+      << ", \"photons\": " << opticalPhotons
+      << ", \"init_s\": " << fInitTime << ", \"run_s\": " << wall
+      << ", \"events_per_s\": " << events * rate
+      << ", \"optical_steps_per_s\": " << opticalSteps * rate
+      << ", \"photons_per_s\": " << opticalPhotons * rate
+      << ", \"peak_rss_mb\": " << rss << "}\n";
+
+  G4cout << "\n-------- Benchmark (" << fLabel << ", " << threads
+         << " threads) --------" << G4endl;
+  G4cout << "Initialization: " << fInitTime << " s, run: " << wall << " s"
+         << G4endl;
+  G4cout << "Events/s: " << events * rate
+         << ", optical steps/s: " << opticalSteps * rate
+         << ", photons/s: " << opticalPhotons * rate << G4endl;
+  G4cout << "Peak RSS: " << rss << " MB" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double Benchmark::GetPeakRSS()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return counters.PeakWorkingSetSize / (1024. * 1024.);
+  return 0.;
+#else
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.;
+#  ifdef __APPLE__
+  return usage.ru_maxrss / (1024. * 1024.);  // bytes
+#  else
+  return usage.ru_maxrss / 1024.;  // kB
+#  endif
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
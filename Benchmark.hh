@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/Benchmark.hh
+/// \brief Definition of the Benchmark class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Benchmark_h
+#define Benchmark_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <cstdint>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Throughput report of a run, appended as one JSON line to the file set
+/// with /opnovice2/bench/file. The clock starts when the instance is first
+/// created (at the top of main), so the initialization time is the time
+/// until the first run starts, physics tables included. Peak RSS is the
+/// high-water mark of the process. Used by the bench target (bench.cmake).
+
+class Benchmark
+{
+ public:
+  static Benchmark* Instance();
+
+  void SetFile(const G4String& fileName) { fFile = fileName; }
+  void SetLabel(const G4String& label) { fLabel = label; }
+  G4bool IsActive() const { return !fFile.empty(); }
+
+  // master, at begin and end of run
+  void BeginOfRun();
+  void EndOfRun(G4int events, std::uint64_t opticalSteps,
+                std::uint64_t opticalPhotons) const;
+
+  // peak resident set size of the process, in MB
+  static G4double GetPeakRSS();
+
+ private:
+  Benchmark();
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point fStart;
+  Clock::time_point fRunStart;
+  G4double fInitTime = -1.;  // s
+  G4String fFile;
+  G4String fLabel = "run";
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
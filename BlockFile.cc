@@ -0,0 +1,261 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/BlockFile.cc
+/// \brief Implementation of the BlockFileWriter and BlockFileReader classes
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "BlockFile.hh"
+
+#include "zlib.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+const std::uint32_t kBlockFileVersion = 1;
+const char kIndexMagic[8] = { 'O', 'P', 'N', '2', 'I', 'N', 'D', 'X' };
+
+struct BlockFileHeader
+{
+  char fMagic[8];
+  std::uint32_t fVersion;
+  std::uint32_t fRecordSize;
+  std::uint32_t fCompression;
+  // uint64, unaligned in this layout: copied with memcpy
+  unsigned char fNumberOfKeys[8];
+  std::uint32_t fReserved;
+};
+static_assert(sizeof(BlockFileHeader) == 32, "unexpected block file header");
+
+struct BlockFileTrailer
+{
+  std::uint64_t fIndexOffset;
+  std::uint64_t fNumberOfBlocks;
+  char fMagic[8];
+};
+static_assert(sizeof(BlockFileTrailer) == 24, "unexpected block file trailer");
+static_assert(sizeof(BlockIndexEntry) == 24, "unexpected block index entry");
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool BlockFileWriter::Open(const G4String& fileName, const char magic[8],
+                             std::uint32_t recordSize, G4bool compress)
+{
+  Close();
+  fOut.open(fileName, std::ios::binary | std::ios::trunc);
+  if(!fOut)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open " << fileName << " for writing.";
+    G4Exception("BlockFileWriter::Open", "OpNovice2_013", JustWarning, ed);
+    return false;
+  }
+  fName            = fileName;
+  fRecordSize      = recordSize;
+  fCompress        = compress;
+  fNumberOfRecords = 0;
+  fNumberOfKeys    = 0;
+  fIndex.clear();
+
+  BlockFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.fMagic, magic, 8);
+  header.fVersion     = kBlockFileVersion;
+  header.fRecordSize  = recordSize;
+  header.fCompression = compress ? 1 : 0;
+  fOut.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fOffset = sizeof(header);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void BlockFileWriter::WriteBlock(const void* records, std::uint32_t nRecords,
+                                 std::int32_t minKey, std::int32_t maxKey)
+{
+  if(!fOut.is_open() || nRecords == 0)
+    return;
+
+  uLong rawSize        = uLong(nRecords) * fRecordSize;
+  const void* data     = records;
+  std::uint32_t stored = std::uint32_t(rawSize);
+  if(fCompress)
+  {
+    uLongf size = compressBound(rawSize);
+    fBuffer.resize(size);
+    // level 1: the writer has to keep up with the workers
+    if(compress2(fBuffer.data(), &size,
+                 static_cast<const Bytef*>(records), rawSize, 1) == Z_OK &&
+       size < rawSize)
+    {
+      data   = fBuffer.data();
+      stored = std::uint32_t(size);
+    }
+  }
+
+  fIndex.push_back({ fOffset, nRecords, stored, minKey, maxKey });
+  std::uint32_t blockHeader[2] = { nRecords, stored };
+  fOut.write(reinterpret_cast<const char*>(blockHeader), sizeof(blockHeader));
+  fOut.write(static_cast<const char*>(data), stored);
+  fOffset += sizeof(blockHeader) + stored;
+  fNumberOfRecords += nRecords;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void BlockFileWriter::Close()
+{
+  if(!fOut.is_open())
+    return;
+
+  BlockFileTrailer trailer;
+  trailer.fIndexOffset    = fOffset;
+  trailer.fNumberOfBlocks = fIndex.size();
+  std::memcpy(trailer.fMagic, kIndexMagic, 8);
+  fOut.write(reinterpret_cast<const char*>(fIndex.data()),
+             fIndex.size() * sizeof(BlockIndexEntry));
+  fOut.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+  fOffset += fIndex.size() * sizeof(BlockIndexEntry) + sizeof(trailer);
+  fOut.seekp(offsetof(BlockFileHeader, fNumberOfKeys));
+  fOut.write(reinterpret_cast<const char*>(&fNumberOfKeys),
+             sizeof(fNumberOfKeys));
+  fOut.close();
+  if(fOut.fail())
+  {
+    G4ExceptionDescription ed;
+    ed << "Error while writing " << fName;
+    G4Exception("BlockFileWriter::Close", "OpNovice2_013", JustWarning, ed);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool BlockFileReader::Open(const G4String& fileName, const char magic[8],
+                             std::uint32_t recordSize)
+{
+  fIndex.clear();
+  fNumberOfKeys = 0;
+  fIn.close();
+  fIn.clear();
+  fIn.open(fileName, std::ios::binary);
+  fName       = fileName;
+  fRecordSize = recordSize;
+
+  BlockFileHeader header;
+  BlockFileTrailer trailer;
+  std::memset(&header, 0, sizeof(header));
+  std::memset(&trailer, 0, sizeof(trailer));
+  fIn.read(reinterpret_cast<char*>(&header), sizeof(header));
+  fIn.seekg(-std::streamoff(sizeof(trailer)), std::ios::end);
+  std::uint64_t indexEnd = std::uint64_t(fIn.tellg());
+  fIn.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+
+  G4ExceptionDescription ed;
+  if(!fIn || std::memcmp(header.fMagic, magic, 8) != 0 ||
+     std::memcmp(trailer.fMagic, kIndexMagic, 8) != 0)
+    ed << fileName << " is not a complete " << std::string(magic, 8)
+       << " file.";
+  else if(header.fVersion != kBlockFileVersion ||
+          header.fRecordSize != recordSize)
+    ed << fileName << " has version " << header.fVersion << " and record size "
+       << header.fRecordSize << "; expected " << kBlockFileVersion << " and "
+       << recordSize << ".";
+  // the index fills the space up to the trailer, checked before it is
+  // allocated
+  else if(trailer.fIndexOffset < sizeof(header) ||
+          trailer.fIndexOffset > indexEnd ||
+          (indexEnd - trailer.fIndexOffset) % sizeof(BlockIndexEntry) != 0 ||
+          trailer.fNumberOfBlocks !=
+            (indexEnd - trailer.fIndexOffset) / sizeof(BlockIndexEntry))
+    ed << fileName << " is truncated or corrupt.";
+  if(ed.str().empty())
+  {
+    fIndex.resize(trailer.fNumberOfBlocks);
+    fIn.seekg(std::streamoff(trailer.fIndexOffset));
+    fIn.read(reinterpret_cast<char*>(fIndex.data()),
+             fIndex.size() * sizeof(BlockIndexEntry));
+    // blocks between header and index; zlib expands at most 1032 times
+    for(const auto& entry : fIndex)
+    {
+      std::uint64_t rawSize =
+        std::uint64_t(entry.fNumberOfRecords) * recordSize;
+      if(!fIn || entry.fOffset < sizeof(header) ||
+         entry.fOffset > trailer.fIndexOffset ||
+         2 * sizeof(std::uint32_t) + entry.fStoredSize >
+           trailer.fIndexOffset - entry.fOffset ||
+         (entry.fStoredSize != rawSize &&
+          rawSize > 1032 * std::uint64_t(entry.fStoredSize)))
+      {
+        ed << fileName << " is truncated or corrupt.";
+        break;
+      }
+    }
+  }
+  if(!ed.str().empty())
+  {
+    G4Exception("BlockFileReader::Open", "OpNovice2_013", JustWarning, ed);
+    fIndex.clear();
+    fIn.close();
+    return false;
+  }
+
+  std::memcpy(&fNumberOfKeys, header.fNumberOfKeys, sizeof(fNumberOfKeys));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::uint64_t BlockFileReader::GetNumberOfRecords() const
+{
+  std::uint64_t n = 0;
+  for(const auto& entry : fIndex)
+    n += entry.fNumberOfRecords;
+  return n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool BlockFileReader::ReadBlock(std::size_t i, std::vector<char>& records)
+{
+  if(i >= fIndex.size())
+    return false;
+  const auto& entry = fIndex[i];
+  uLongf rawSize    = uLongf(entry.fNumberOfRecords) * fRecordSize;
+  records.resize(rawSize);
+
+  fIn.seekg(std::streamoff(entry.fOffset + 2 * sizeof(std::uint32_t)));
+  if(entry.fStoredSize == rawSize)
+  {
+    fIn.read(records.data(), rawSize);
+    return bool(fIn);
+  }
+  fBuffer.resize(entry.fStoredSize);
+  fIn.read(reinterpret_cast<char*>(fBuffer.data()), entry.fStoredSize);
+  return fIn && uncompress(reinterpret_cast<Bytef*>(records.data()),
+                           &rawSize, fBuffer.data(),
+                           entry.fStoredSize) == Z_OK;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
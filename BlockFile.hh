@@ -0,0 +1,132 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/BlockFile.hh
+/// \brief Definition of the BlockFileWriter and BlockFileReader classes
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef BlockFile_h
+#define BlockFile_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Binary file of fixed-size records, stored in independently compressed
+/// blocks followed by an index.
+///
+/// Layout: a 32-byte header (8-byte magic naming the record type, uint32
+/// format version, uint32 record size, uint32 compression 0 = none or
+/// 1 = zlib, uint64 number of keys, e.g. events, 0 if unknown, 4 bytes
+/// reserved), then blocks of (uint32 number of records,
+/// uint32 stored size, data), then the index with one BlockIndexEntry per
+/// block, and a 24-byte trailer (uint64 index offset, uint64 number of
+/// blocks, magic "OPN2INDX"). A block is stored uncompressed when zlib does
+/// not make it smaller. Readers seek to the trailer, load the index and can
+/// then decompress any block on its own.
+
+struct BlockIndexEntry
+{
+  std::uint64_t fOffset;  // of the block header in the file
+  std::uint32_t fNumberOfRecords;
+  std::uint32_t fStoredSize;
+  std::int32_t fMinKey;  // key range of the block, e.g. event IDs
+  std::int32_t fMaxKey;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class BlockFileWriter
+{
+ public:
+  BlockFileWriter() = default;
+  ~BlockFileWriter() { Close(); }
+
+  BlockFileWriter(const BlockFileWriter&) = delete;
+  BlockFileWriter& operator=(const BlockFileWriter&) = delete;
+
+  G4bool Open(const G4String& fileName, const char magic[8],
+              std::uint32_t recordSize, G4bool compress);
+  void WriteBlock(const void* records, std::uint32_t nRecords,
+                  std::int32_t minKey, std::int32_t maxKey);
+  // distinct keys written, stored in the header at Close
+  void SetNumberOfKeys(std::uint64_t n) { fNumberOfKeys = n; }
+  // writes the index and trailer
+  void Close();
+
+  G4bool IsOpen() const { return fOut.is_open(); }
+  std::uint64_t GetNumberOfRecords() const { return fNumberOfRecords; }
+  std::uint64_t GetBytesWritten() const { return fOffset; }
+
+ private:
+  std::ofstream fOut;
+  G4String fName;
+  std::uint32_t fRecordSize = 0;
+  G4bool fCompress = false;
+  std::uint64_t fOffset = 0;
+  std::uint64_t fNumberOfRecords = 0;
+  std::uint64_t fNumberOfKeys = 0;
+  std::vector<BlockIndexEntry> fIndex;
+  std::vector<unsigned char> fBuffer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class BlockFileReader
+{
+ public:
+  BlockFileReader() = default;
+  ~BlockFileReader() = default;
+
+  G4bool Open(const G4String& fileName, const char magic[8],
+              std::uint32_t recordSize);
+
+  std::size_t GetNumberOfBlocks() const { return fIndex.size(); }
+  const std::vector<BlockIndexEntry>& GetIndex() const { return fIndex; }
+  std::uint64_t GetNumberOfRecords() const;
+  std::uint64_t GetNumberOfKeys() const { return fNumberOfKeys; }
+
+  // decompresses block i into records, resized to its record count
+  G4bool ReadBlock(std::size_t i, std::vector<char>& records);
+
+ private:
+  std::ifstream fIn;
+  G4String fName;
+  std::uint32_t fRecordSize = 0;
+  std::uint64_t fNumberOfKeys = 0;
+  std::vector<BlockIndexEntry> fIndex;
+  std::vector<unsigned char> fBuffer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
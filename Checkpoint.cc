@@ -0,0 +1,200 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/Checkpoint.cc
+/// \brief Implementation of the Checkpoint class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Checkpoint.hh"
+
+#include "Run.hh"
+#include "Shard.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+Checkpoint* Checkpoint::Instance()
+{
+  static Checkpoint instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Checkpoint::BeamOn(G4long events)
+{
+  auto runManager = G4RunManager::GetRunManager();
+  if(fFile.empty() || fEvery <= 0)
+  {
+    runManager->BeamOn(G4int(events));
+    return;
+  }
+
+  G4String fileName     = StateFileName();
+  auto shard            = Shard::Instance();
+  fProgress             = RunProgress();
+  fProgress.fShardIndex = shard->GetIndex();
+  fProgress.fShardCount = shard->GetCount();
+  fProgress.fEvents     = events;
+  fResumed              = Resumed();
+  if(fResume && std::ifstream(fileName).good())
+  {
+    RunProgress progress;
+    if(!RunState::ReadProgress(fileName, progress) ||
+       progress.fEvents != events)
+    {
+      G4ExceptionDescription ed;
+      ed << fileName << " is not the checkpoint of a run of " << events
+         << " events; run not started.";
+      G4Exception("Checkpoint::BeamOn", "OpNovice2_023", JustWarning, ed);
+      return;
+    }
+    // as it was after the last segment, so the next one draws the same
+    // worker seeds and gets the same run ID
+    std::istringstream engine(progress.fEngineState);
+    G4Random::restoreFullState(engine);
+    runManager->SetRunIDCounter(progress.fNextRunID);
+    fProgress = progress;
+    G4cout << "Resuming from " << fileName << ": " << progress.fEventsDone
+           << " of " << events << " events done" << G4endl;
+    if(progress.fEventsDone >= events)
+      return;
+  }
+
+  fActive       = true;
+  fFirstSegment = true;
+  fLastSegment  = false;
+  while(!fLastSegment)
+  {
+    fSegmentEnded = false;
+    runManager->BeamOn(
+      G4int(std::min<G4long>(fEvery, events - fProgress.fEventsDone)));
+    // the run did not start (no geometry, ...)
+    if(!fSegmentEnded)
+      break;
+  }
+  fActive       = false;
+  fFirstSegment = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Checkpoint::BeginOfSegment(Run& run, G4int runID)
+{
+  if(!fActive)
+    return;
+  if(fProgress.fRunID < 0)
+    fProgress.fRunID = runID;
+  fSegmentStart = fProgress.fEventsDone;
+  if(fSegmentStart == 0)
+    return;
+
+  // the merged H1s of the workers are added to those restored
+  G4AnalysisManager::Instance()->Reset();
+  RunProgress progress;
+  if(!RunState::Read(StateFileName(), run, &progress) ||
+     progress.fEventsDone != fSegmentStart)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot restore the run from " << StateFileName() << ".";
+    G4Exception("Checkpoint::BeginOfSegment", "OpNovice2_023", FatalException,
+                ed);
+    return;
+  }
+  if(fFirstSegment)
+  {
+    fResumed.fEvents        = run.GetNumberOfEvent();
+    fResumed.fOpticalSteps  = run.GetOpticalSteps();
+    fResumed.fOpticalTracks = run.GetOpticalTracks();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool Checkpoint::EndOfSegment(const Run& run)
+{
+  if(!fActive)
+    return true;
+  fSegmentEnded = true;
+  fFirstSegment = false;
+
+  fProgress.fEventsDone = run.GetNumberOfEvent();
+  fProgress.fNextRunID  = run.GetRunID() + 1;
+  std::ostringstream engine;
+  G4Random::saveFullState(engine);
+  fProgress.fEngineState = engine.str();
+  G4String fileName      = StateFileName();
+  RunState::Write(fileName, run, fProgress);
+
+  G4bool aborted = fProgress.fEventsDone - fSegmentStart <
+                   run.GetNumberOfEventToBeProcessed();
+  fLastSegment   = aborted || fProgress.fEventsDone >= fProgress.fEvents;
+  if(!fLastSegment)
+    G4cout << "Checkpoint " << fileName << ": " << fProgress.fEventsDone
+           << " of " << fProgress.fEvents << " events done" << G4endl;
+  return fLastSegment;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4int Checkpoint::GetRunID(G4int runID) const
+{
+  return fActive ? fProgress.fRunID : runID;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4long Checkpoint::GetEvents(G4long events) const
+{
+  return fActive ? fProgress.fEvents : events;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4long Checkpoint::GetFirstEvent() const
+{
+  return fActive ? fSegmentStart : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4String Checkpoint::FileName(const G4String& name) const
+{
+  if(!fActive || fSegmentStart == 0)
+    return name;
+  std::ostringstream tag;
+  tag << "_seg" << fSegmentStart / fEvery;
+  return Shard::AddTag(name, tag.str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4String Checkpoint::StateFileName() const
+{
+  return Shard::Instance()->FileName(fFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
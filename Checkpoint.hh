@@ -0,0 +1,119 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/Checkpoint.hh
+/// \brief Definition of the Checkpoint class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Checkpoint_h
+#define Checkpoint_h 1
+
+#include "RunState.hh"
+
+#include "globals.hh"
+
+#include <cstdint>
+
+class Run;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Checkpoints of a long run (/opnovice2/checkpoint/beamOn N).
+///
+/// The run is made of segments of /opnovice2/checkpoint/every events, each
+/// a Geant4 run, that carry on one logical run: the merged Run and H1s of
+/// the previous segments are restored at begin of segment, and the event
+/// seeds keep the run ID and global event IDs of the whole run. After each
+/// segment the merged state, the master engine (the workers are reseeded
+/// from it) and the events done are written to a RunState file, atomically.
+///
+/// With OpNovice2 --resume a killed job rerun with the same macro starts
+/// from its checkpoint; the result is that of the uninterrupted job, and
+/// with /opnovice2/gun/eventSeed that of a single /run/beamOn N.
+
+class Checkpoint
+{
+ public:
+  // counters restored when this process resumed a run, to be subtracted
+  // from those of the run for throughput reports
+  struct Resumed
+  {
+    G4int fEvents = 0;
+    std::uint64_t fOpticalSteps = 0;
+    std::uint64_t fOpticalTracks = 0;
+  };
+
+  static Checkpoint* Instance();
+
+  void SetFile(const G4String& fileName) { fFile = fileName; }
+  void SetEvery(G4int events) { fEvery = events; }
+  void SetResume(G4bool resume) { fResume = resume; }
+
+  // master: n events in checkpointed segments; a plain /run/beamOn n
+  // without a file or with every <= 0
+  void BeamOn(G4long events);
+
+  // master, from RunAction; BeginOfSegment restores the earlier segments
+  // into run, EndOfSegment writes the checkpoint and returns true after
+  // the last segment, or if the run was aborted
+  void BeginOfSegment(Run& run, G4int runID);
+  G4bool EndOfSegment(const Run& run);
+
+  G4bool IsActive() const { return fActive; }
+  // true unless a segment of this process has already run
+  G4bool IsFirstSegment() const { return fFirstSegment; }
+  // run ID, events and first event of the logical run
+  G4int GetRunID(G4int runID) const;
+  G4long GetEvents(G4long events) const;
+  G4long GetFirstEvent() const;
+  const Resumed& GetResumed() const { return fResumed; }
+
+  // name.ext -> name_seg<k>.ext for the segments after the first
+  G4String FileName(const G4String& name) const;
+
+ private:
+  Checkpoint() = default;
+
+  G4String StateFileName() const;
+
+  G4String fFile;
+  G4int fEvery = 0;
+  G4bool fResume = false;
+
+  G4bool fActive = false;
+  G4bool fFirstSegment = true;
+  G4bool fSegmentEnded = false;
+  G4bool fLastSegment = false;
+  G4long fSegmentStart = 0;
+  RunProgress fProgress;
+  Resumed fResumed;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/CompensatedSum.hh
+/// \brief Definition of the CompensatedSum class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef CompensatedSum_h
+#define CompensatedSum_h 1
+
+#include "globals.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Neumaier (improved Kahan) summation. Keeps sums of 10^9 and more terms
+/// accurate to the last bits, which matters for variances computed as
+/// differences of large second and squared first moments.
+
+class CompensatedSum
+{
+ public:
+  void Add(G4double x)
+  {
+    G4double t = fSum + x;
+    if(std::abs(fSum) >= std::abs(x))
+      fCompensation += (fSum - t) + x;
+    else
+      fCompensation += (x - t) + fSum;
+    fSum = t;
+  }
+
+  void Add(const CompensatedSum& other)
+  {
+    Add(other.fSum);
+    Add(other.fCompensation);
+  }
+
+  G4double Value() const { return fSum + fCompensation; }
+
+ private:
+  G4double fSum = 0.;
+  G4double fCompensation = 0.;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,232 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/DepositFile.cc
+/// \brief Implementation of the DepositStream and DepositReader classes
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "DepositFile.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+
+namespace
+{
+const char kDepositMagic[8] = { 'O', 'P', 'N', '2', 'E', 'D', 'E', 'P' };
+const std::size_t kBlockDeposits = std::size_t(1) << 16;
+
+// blocks handed out to the readers of all threads in the current run
+std::atomic<std::size_t> nextBlock{ 0 };
+std::atomic<G4int> replayRun{ 0 };
+std::atomic<G4bool> usedUp{ false };
+}  // namespace
+
+static_assert(sizeof(EnergyDeposit) == 28, "unexpected deposit record");
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+DepositStream* DepositStream::Instance()
+{
+  static DepositStream instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+DepositStream::~DepositStream()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DepositStream::Open(const G4String& fileName, G4bool compress)
+{
+  Close();
+  G4AutoLock lock(&fMutex);
+  if(!fFile.Open(fileName, kDepositMagic, sizeof(EnergyDeposit), compress))
+    return;
+  fEvents = 0;
+  fOpen.store(true, std::memory_order_release);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DepositStream::Close()
+{
+  if(!fOpen.exchange(false))
+    return;
+  G4AutoLock lock(&fMutex);
+  fFile.SetNumberOfKeys(fEvents);
+  fFile.Close();
+  G4cout << "Deposit file: " << fFile.GetNumberOfRecords() << " deposits of "
+         << fEvents << " events (" << fFile.GetBytesWritten() / 1024
+         << " kB)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::vector<EnergyDeposit>& DepositStream::GetLocalBuffer()
+{
+  static G4ThreadLocal std::vector<EnergyDeposit>* buffer = nullptr;
+  if(!buffer)
+  {
+    buffer = new std::vector<EnergyDeposit>;
+    buffer->reserve(kBlockDeposits);
+  }
+  return *buffer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DepositStream::Add(const EnergyDeposit& deposit)
+{
+  GetLocalBuffer().push_back(deposit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DepositStream::EndEvent()
+{
+  auto& buffer = GetLocalBuffer();
+  if(buffer.size() >= kBlockDeposits)
+    WriteBuffer(buffer);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DepositStream::FlushThread()
+{
+  auto& buffer = GetLocalBuffer();
+  if(IsOpen())
+    WriteBuffer(buffer);
+  buffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DepositStream::WriteBuffer(std::vector<EnergyDeposit>& buffer)
+{
+  if(!buffer.empty())
+  {
+    // events of one thread come in increasing order
+    std::uint64_t events = 1;
+    for(std::size_t i = 1; i < buffer.size(); ++i)
+      if(buffer[i].fEventID != buffer[i - 1].fEventID)
+        ++events;
+
+    G4AutoLock lock(&fMutex);
+    fFile.WriteBlock(buffer.data(), std::uint32_t(buffer.size()),
+                     buffer.front().fEventID, buffer.back().fEventID);
+    fEvents += events;
+  }
+  buffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+DepositReader::DepositReader(const G4String& fileName)
+  : fName(fileName)
+{
+  if(!fFile.Open(fileName, kDepositMagic, sizeof(EnergyDeposit)))
+    return;
+
+  // once, not per thread
+  if(G4Threading::G4GetThreadId() > 0)
+    return;
+  if(!IsValid())
+  {
+    G4ExceptionDescription ed;
+    ed << fileName << " holds no deposits.";
+    G4Exception("DepositReader::DepositReader", "OpNovice2_017", JustWarning,
+                ed);
+    return;
+  }
+  G4cout << "Deposit file " << fileName << ": ";
+  if(fFile.GetNumberOfKeys() > 0)
+    G4cout << fFile.GetNumberOfKeys() << " events stored, the most "
+           << "/run/beamOn can replay" << G4endl;
+  else
+    G4cout << fFile.GetNumberOfRecords() << " deposits, number of events "
+           << "not recorded" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DepositReader::Rewind()
+{
+  nextBlock.store(0);
+  usedUp.store(false);
+  ++replayRun;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool DepositReader::NextBlock()
+{
+  fRecords.clear();
+  fNext             = 0;
+  std::size_t block = nextBlock.fetch_add(1);
+  if(block >= fFile.GetNumberOfBlocks())
+  {
+    if(!usedUp.exchange(true))
+    {
+      G4ExceptionDescription ed;
+      ed << "All the events of " << fName << " are replayed; run aborted. "
+         << "Ask /run/beamOn for at most the number of stored events.";
+      G4Exception("DepositReader::NextEvent", "OpNovice2_017", JustWarning,
+                  ed);
+    }
+    return false;
+  }
+  return fFile.ReadBlock(block, fRecords);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool DepositReader::NextEvent(std::vector<EnergyDeposit>& deposits)
+{
+  deposits.clear();
+  if(!IsValid())
+    return false;
+  // a new run: what is left of the block of the last run is not replayed
+  G4int run = replayRun.load();
+  if(run != fRun)
+  {
+    fRun = run;
+    fRecords.clear();
+    fNext = 0;
+  }
+
+  auto records = reinterpret_cast<const EnergyDeposit*>(fRecords.data());
+  std::size_t n = fRecords.size() / sizeof(EnergyDeposit);
+  if(fNext >= n)
+  {
+    if(!NextBlock())
+      return false;
+    records = reinterpret_cast<const EnergyDeposit*>(fRecords.data());
+    n       = fRecords.size() / sizeof(EnergyDeposit);
+  }
+
+  // blocks never split an event
+  std::size_t first = fNext;
+  while(fNext < n && records[fNext].fEventID == records[first].fEventID)
+    ++fNext;
+  deposits.assign(records + first, records + fNext);
+  return !deposits.empty();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
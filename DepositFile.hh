@@ -0,0 +1,129 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/DepositFile.hh
+/// \brief Definition of the DepositStream and DepositReader classes
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef DepositFile_h
+#define DepositFile_h 1
+
+#include "BlockFile.hh"
+#include "G4AutoLock.hh"
+
+#include <atomic>
+#include <cstdint>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// One energy-deposition step in the scintillator, 28 bytes: midpoint of
+/// the step [mm], global time [ns], deposited and visible (Birks-quenched)
+/// energy [keV]. The photon yield is applied at replay, so a deposit file
+/// can be replayed with any light yield.
+struct EnergyDeposit
+{
+  std::int32_t fEventID;
+  float fPosition[3];
+  float fTime;
+  float fEdep;
+  float fVisible;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Stage 1 of the two-stage pipeline: deposits of all threads go to one
+/// BlockFile (magic "OPN2EDEP"). Every worker buffers its deposits and
+/// writes them only between events, so a block always holds whole events
+/// and its index key range is the range of their event IDs.
+
+class DepositStream
+{
+ public:
+  static DepositStream* Instance();
+
+  // master thread, around the event loop
+  void Open(const G4String& fileName, G4bool compress);
+  void Close();
+  G4bool IsOpen() const { return fOpen.load(std::memory_order_acquire); }
+
+  // worker threads
+  void Add(const EnergyDeposit& deposit);
+  void EndEvent();
+  // writes this thread's remaining deposits; call at end of run
+  void FlushThread();
+
+ private:
+  DepositStream() = default;
+  ~DepositStream();
+
+  std::vector<EnergyDeposit>& GetLocalBuffer();
+  void WriteBuffer(std::vector<EnergyDeposit>& buffer);
+
+  std::atomic<G4bool> fOpen{ false };
+  G4Mutex fMutex;
+  BlockFileWriter fFile;
+  std::uint64_t fEvents = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Stage 2: reads the events of a deposit file back, one at a time. Each
+/// worker opens its own reader, and the blocks are handed out in turn from
+/// a cursor shared by all threads, so that every stored event is replayed
+/// at most once per run whatever the scheduling. Once the blocks are used
+/// up the run is aborted; it never starts over.
+
+class DepositReader
+{
+ public:
+  explicit DepositReader(const G4String& fileName);
+  ~DepositReader() = default;
+
+  G4bool IsValid() const { return fFile.GetNumberOfBlocks() > 0; }
+  const G4String& GetName() const { return fName; }
+
+  // deposits of the next event, with its event ID in the deposit file;
+  // false when no stored event is left in this run
+  G4bool NextEvent(std::vector<EnergyDeposit>& deposits);
+
+  // master, at begin of run: the run replays the file from the start
+  static void Rewind();
+
+ private:
+  G4bool NextBlock();
+
+  G4String fName;
+  BlockFileReader fFile;
+  G4int fRun = -1;
+  std::vector<char> fRecords;
+  std::size_t fNext = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -162,6 +162,10 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   pdSurfMPT->AddProperty("REFLECTIVITY", photonE, reflectivity, n);
   pdSurfMPT->AddProperty("EFFICIENCY", photonE, efficiency, n);
   pdSurf->SetMaterialPropertiesTable(pdSurfMPT);
+  fPDSurfaceMPT = pdSurfMPT;
+  fPDTabulated.clear();
+  if(fPDPerfectAbsorber)
+    SetPDPerfectAbsorber(true);
 
   // Define border surface from Tank to PD
   new G4LogicalBorderSurface("TankToPD", fTank, fPD_PV, pdSurf);
@@ -177,18 +181,21 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   reflectiveSurface->SetModel(unified);
   
   auto reflectiveMPT = new G4MaterialPropertiesTable();
-  G4double refl_values[n] = { 0.98, 0.98, 0.98, 0.98 };  // 98% reflective
+  G4double refl_values[n] = { fWrapReflectivity, fWrapReflectivity,
+                              fWrapReflectivity, fWrapReflectivity };
   G4double refl_eff[n] = { 0.0, 0.0, 0.0, 0.0 };         // Not a detector
   
   reflectiveMPT->AddProperty("REFLECTIVITY", photonE, refl_values, n);
   reflectiveMPT->AddProperty("EFFICIENCY", photonE, refl_eff, n);
   reflectiveSurface->SetMaterialPropertiesTable(reflectiveMPT);
+  fWrapMPT = reflectiveMPT;
   
   // Apply reflective surface to Tank-World boundary (all 5 sides except +Z)
   new G4LogicalSkinSurface("ReflectiveWrap", fTank_LV, reflectiveSurface);
   
   G4cout << "\n*** REFLECTIVE WRAPPING ADDED ***" << G4endl;
-  G4cout << "98% reflective on 5 sides (not +Z face)" << G4endl;
+  G4cout << fWrapReflectivity * 100. << "% reflective on 5 sides (not +Z face)"
+         << G4endl;
   G4cout << "This channels photons toward photodiode" << G4endl;
   G4cout << "**********************************\n" << G4endl;
 
@@ -232,6 +239,45 @@ void DetectorConstruction::SetSurfaceSigmaAlpha(G4double v)
          << G4endl;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetWrapReflectivity(G4double r)
+{
+  fWrapReflectivity = r;
+  // the boundary process looks the table up at every reflection
+  if(fWrapMPT)
+  {
+    G4MaterialPropertyVector* refl = fWrapMPT->GetProperty("REFLECTIVITY");
+    for(std::size_t i = 0; i < refl->GetVectorLength(); ++i)
+      refl->PutValue(i, r);
+  }
+  G4cout << "Wrap reflectivity set to: " << fWrapReflectivity << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetPDPerfectAbsorber(G4bool val)
+{
+  fPDPerfectAbsorber = val;
+  if(!fPDSurfaceMPT)
+    return;
+
+  G4MaterialPropertyVector* refl = fPDSurfaceMPT->GetProperty("REFLECTIVITY");
+  G4MaterialPropertyVector* eff  = fPDSurfaceMPT->GetProperty("EFFICIENCY");
+  // keep the tabulated values so that the mode can be switched back
+  if(fPDTabulated.empty())
+  {
+    for(std::size_t i = 0; i < refl->GetVectorLength(); ++i)
+      fPDTabulated.emplace_back((*refl)[i], (*eff)[i]);
+  }
+  for(std::size_t i = 0; i < fPDTabulated.size(); ++i)
+  {
+    refl->PutValue(i, val ? 0. : fPDTabulated[i].first);
+    eff->PutValue(i, val ? 1. : fPDTabulated[i].second);
+  }
+  G4cout << "Photodiode surface: "
+         << (val ? "perfect absorber" : "tabulated reflectivity and QE")
+         << G4endl;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void DetectorConstruction::SetSurfacePolish(G4double v)
 {
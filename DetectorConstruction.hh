@@ -8,6 +8,9 @@
 
 #include <CLHEP/Units/SystemOfUnits.h>
 
+#include <utility>
+#include <vector>
+
 class DetectorMessenger;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -81,6 +84,15 @@ class DetectorConstruction : public G4VUserDetectorConstruction
   G4double GetTankY() const { return fTank_y; }
   G4double GetTankZ() const { return fTank_z; }   // half-lengths
 
+  // reflectivity of the ReflectiveWrap skin, flat in energy
+  void SetWrapReflectivity(G4double r);
+  G4double GetWrapReflectivity() const { return fWrapReflectivity; }
+
+  // photodiode face with no reflection and EFFICIENCY 1, so that any QE
+  // curve can be applied to the arrival spectrum afterwards
+  void SetPDPerfectAbsorber(G4bool val);
+  G4bool GetPDPerfectAbsorber() const { return fPDPerfectAbsorber; }
+
   G4double GetTankXSize() const { return fTank_x; }
   G4double GetTankYSize() const { return fTank_y; }
 
@@ -108,6 +120,11 @@ class DetectorConstruction : public G4VUserDetectorConstruction
   G4Material* fTankMaterial = nullptr;
 
   G4OpticalSurface* fSurface = nullptr;
+  G4double fWrapReflectivity = 0.98;
+  G4MaterialPropertiesTable* fWrapMPT = nullptr;
+  G4bool fPDPerfectAbsorber = false;
+  G4MaterialPropertiesTable* fPDSurfaceMPT = nullptr;
+  std::vector<std::pair<G4double, G4double>> fPDTabulated;  // refl., eff.
 
   DetectorMessenger* fDetectorMessenger = nullptr;
 
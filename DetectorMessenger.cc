@@ -35,6 +35,7 @@
 #include "DetectorConstruction.hh"
 
 #include "G4OpticalSurface.hh"
+#include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithAnInteger.hh"
@@ -98,6 +99,25 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* Det)
   fSurfaceMatPropConstCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
   fSurfaceMatPropConstCmd->SetToBeBroadcasted(false);
 
+  fWrapReflectivityCmd =
+    new G4UIcmdWithADouble("/opnovice2/wrapReflectivity", this);
+  fWrapReflectivityCmd->SetGuidance("Reflectivity of the wrapping on the");
+  fWrapReflectivityCmd->SetGuidance(" CsI faces other than the photodiode.");
+  fWrapReflectivityCmd->SetParameterName("reflectivity", false);
+  fWrapReflectivityCmd->SetRange("reflectivity>=0. && reflectivity<=1.");
+  fWrapReflectivityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fWrapReflectivityCmd->SetToBeBroadcasted(false);
+
+  fPDPerfectAbsorberCmd =
+    new G4UIcmdWithABool("/opnovice2/pdPerfectAbsorber", this);
+  fPDPerfectAbsorberCmd->SetGuidance("Make the photodiode face absorb and");
+  fPDPerfectAbsorberCmd->SetGuidance(" detect every photon; QE curves are");
+  fPDPerfectAbsorberCmd->SetGuidance(" then applied with /opnovice2/reweight/qeFile.");
+  fPDPerfectAbsorberCmd->SetParameterName("perfect", true);
+  fPDPerfectAbsorberCmd->SetDefaultValue(true);
+  fPDPerfectAbsorberCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPDPerfectAbsorberCmd->SetToBeBroadcasted(false);
+
   fTankMatPropVectorCmd =
     new G4UIcmdWithAString("/opnovice2/boxProperty", this);
   fTankMatPropVectorCmd->SetGuidance("Set material property vector for ");
@@ -149,6 +169,8 @@ DetectorMessenger::~DetectorMessenger()
   delete fSurfacePolishCmd;
   delete fSurfaceMatPropVectorCmd;
   delete fSurfaceMatPropConstCmd;
+  delete fWrapReflectivityCmd;
+  delete fPDPerfectAbsorberCmd;
   delete fTankMatPropVectorCmd;
   delete fTankMatPropConstCmd;
   delete fTankMaterialCmd;
@@ -400,6 +422,16 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
     fDetector->SetSurfacePolish(
       G4UIcmdWithADouble::GetNewDoubleValue(newValue));
   }
+  else if(command == fWrapReflectivityCmd)
+  {
+    fDetector->SetWrapReflectivity(
+      G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+  }
+  else if(command == fPDPerfectAbsorberCmd)
+  {
+    fDetector->SetPDPerfectAbsorber(
+      G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
   else if(command == fTankMatPropVectorCmd)
   {
     // got a string. need to convert it to physics vector.
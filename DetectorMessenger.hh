@@ -39,6 +39,7 @@
 class DetectorConstruction;
 class G4UIdirectory;
 class G4UIcommand;
+class G4UIcmdWithABool;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
 class G4UIcmdWithADouble;
@@ -67,6 +68,8 @@ class DetectorMessenger : public G4UImessenger
   G4UIcmdWithADouble* fSurfacePolishCmd = nullptr;
   G4UIcmdWithAString* fSurfaceMatPropVectorCmd = nullptr;
   G4UIcmdWithAString* fSurfaceMatPropConstCmd = nullptr;
+  G4UIcmdWithADouble* fWrapReflectivityCmd = nullptr;
+  G4UIcmdWithABool* fPDPerfectAbsorberCmd = nullptr;
 
   // the box
   G4UIcmdWithAString* fTankMatPropVectorCmd = nullptr;
@@ -0,0 +1,175 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/EventAction.cc
+/// \brief Implementation of the EventAction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventAction.hh"
+
+#include "DepositFile.hh"
+#include "EventSeeder.hh"
+#include "EventTuple.hh"
+#include "PrecisionMonitor.hh"
+#include "ProgressMonitor.hh"
+#include "Run.hh"
+#include "Shard.hh"
+
+#include "G4Event.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RunManager.hh"
+
+#include <algorithm>
+#include <cstring>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventAction::BeginOfEventAction(const G4Event* event)
+{
+  fRecord          = EventRecord();
+  // global over shards and checkpoint segments, as in the output streams
+  fRecord.fEventID =
+    G4int(Shard::Instance()->GetGlobalEventID(event->GetEventID()));
+  fEdep            = 0.;
+  fFirstDepth      = -1.;
+
+  // photon sources (response calibration, deposit replay) emit one vertex
+  // per optical photon; such an event counts as a single primary
+  G4int nPrimaries = event->GetNumberOfPrimaryVertex();
+  auto first       = nPrimaries > 0 ? event->GetPrimaryVertex(0) : nullptr;
+  if(first && first->GetPrimary() &&
+     first->GetPrimary()->GetG4code() ==
+       G4OpticalPhoton::OpticalPhotonDefinition())
+    nPrimaries = 1;
+  fDetectedPerPrimary.assign(std::max(nPrimaries, 1), 0);
+
+  fEntrance.clear();
+  for(G4int i = 0; i < nPrimaries; ++i)
+    fEntrance.push_back(event->GetPrimaryVertex(i)->GetPosition());
+  fEntered.assign(fEntrance.size(), false);
+
+  fStart = std::chrono::steady_clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventAction::SetEntrance(G4int primaryIndex,
+                              const G4ThreeVector& position)
+{
+  // keep the first crossing only
+  if(primaryIndex < 0 || primaryIndex >= (G4int) fEntrance.size() ||
+     fEntered[primaryIndex])
+    return;
+  fEntrance[primaryIndex] = position;
+  fEntered[primaryIndex]  = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventAction::AddDetected(G4int primaryIndex)
+{
+  fRecord.fDetected += 1;
+  if(primaryIndex >= 0 &&
+     primaryIndex < (G4int) fDetectedPerPrimary.size())
+    fDetectedPerPrimary[primaryIndex] += 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventAction::EndOfEventAction(const G4Event* event)
+{
+  // generated after the end of the replayed events, see DepositReader
+  if(event->IsAborted())
+    return;
+  auto run = static_cast<Run*>(
+    G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  if(auto timing = run->GetEventTiming())
+  {
+    G4double wallTime = std::chrono::duration<G4double>(
+                          std::chrono::steady_clock::now() - fStart)
+                          .count();
+    auto vertex = event->GetPrimaryVertex();
+    auto primary = vertex ? vertex->GetPrimary() : nullptr;
+    if(!primary || !timing->IsSlow(wallTime))
+      timing->FillTime(wallTime);
+    else
+    {
+      SlowEvent slow;
+      slow.fEventID      =
+        G4int(Shard::Instance()->GetGlobalEventID(event->GetEventID()));
+      slow.fWallTime     = wallTime;
+      slow.fParticle     = primary->GetG4code()->GetParticleName();
+      slow.fEnergy       = primary->GetKineticEnergy();
+      slow.fPosition     = vertex->GetPosition();
+      slow.fDirection    = primary->GetMomentumDirection();
+      slow.fPrimaries    = (G4int) fDetectedPerPrimary.size();
+      slow.fRandomStatus = event->GetRandomNumberStatus();
+      timing->Fill(slow);
+    }
+  }
+  ProgressMonitor::AddEvent();
+  run->AddFrame(fRecord.fDetected, fDetectedPerPrimary);
+  run->AddPulseHeight(fRecord.fDetected, fEdep > 0.);
+  if(run->GetOpticalReweighter().IsActive())
+    run->GetOpticalReweighter().EndEvent();
+
+  auto monitor = PrecisionMonitor::Instance();
+  if(monitor->IsActive() &&
+     monitor->AddEvent(fRecord.fDetected, fRecord.fScintillation))
+  {
+    // finish this event, then end the run on this thread
+    G4RunManager::GetRunManager()->AbortRun(true);
+  }
+
+  auto vertex = event->GetPrimaryVertex();
+  if(vertex && vertex->GetPrimary())
+    fRecord.fEnergy = vertex->GetPrimary()->GetKineticEnergy();
+  fRecord.fEdep = fEdep;
+
+  // order-independent digest of the run: identical whatever the threads
+  // when events are seeded with /opnovice2/gun/eventSeed, and the sum of
+  // the digests of the shards of a run split with --shard
+  std::uint64_t edepBits;
+  std::memcpy(&edepBits, &fEdep, sizeof(edepBits));
+  std::uint64_t digest =
+    EventSeeder::Mix(std::uint64_t(fRecord.fEventID));
+  digest = EventSeeder::Mix(digest ^ std::uint64_t(fRecord.fDetected));
+  digest = EventSeeder::Mix(digest ^ std::uint64_t(fRecord.fScintillation));
+  run->AddEventDigest(EventSeeder::Mix(digest ^ edepBits));
+
+  auto deposits = DepositStream::Instance();
+  if(deposits->IsOpen())
+    deposits->EndEvent();
+
+  auto tuple = EventTuple::Instance();
+  if(tuple->IsOpen())
+    tuple->Fill(fRecord, fFirstDepth);
+  if(run->GetRecordEvents())
+    run->AddEventRecord(fRecord);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
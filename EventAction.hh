@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/EventAction.hh
+/// \brief Definition of the EventAction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventAction_h
+#define EventAction_h 1
+
+#include "globals.hh"
+#include "G4UserEventAction.hh"
+#include "G4ThreeVector.hh"
+
+#include <chrono>
+#include <vector>
+
+class G4Event;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Per-event results, kept together with the true primary energy so that
+/// a run can be reweighted to another spectrum afterwards.
+struct EventRecord
+{
+  G4int fEventID = 0;
+  G4float fEnergy = 0.;  // true primary energy
+  G4int fScintillation = 0;  // scintillation photons created
+  G4int fDetected = 0;  // photons detected at the photodiode
+  G4float fEdep = 0.;  // energy deposited in the scintillator
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class EventAction : public G4UserEventAction
+{
+ public:
+  EventAction() = default;
+  ~EventAction() override = default;
+
+  void BeginOfEventAction(const G4Event*) override;
+  void EndOfEventAction(const G4Event*) override;
+
+  void AddScintillation() { fRecord.fScintillation += 1; }
+  // primaryIndex attributes the photon to one primary of the event
+  void AddDetected(G4int primaryIndex = 0);
+  void AddEdep(G4double edep) { fEdep += edep; }
+  // where each primary entered the scintillator; starts at its vertex
+  void SetEntrance(G4int primaryIndex, const G4ThreeVector& position);
+  const G4ThreeVector* GetEntrance(G4int primaryIndex) const
+  {
+    if(primaryIndex < 0 || primaryIndex >= (G4int) fEntrance.size())
+      return nullptr;
+    return &fEntrance[primaryIndex];
+  }
+
+  // depth below the entrance face of the first energy deposit
+  void SetFirstDepth(G4double depth)
+  {
+    if(fFirstDepth < 0.)
+      fFirstDepth = depth;
+  }
+
+ private:
+  EventRecord fRecord;
+  G4double fEdep = 0.;
+  G4double fFirstDepth = -1.;
+  std::vector<G4int> fDetectedPerPrimary;
+  std::vector<G4ThreeVector> fEntrance;
+  std::vector<G4bool> fEntered;
+  std::chrono::steady_clock::time_point fStart;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/EventSeeder.cc
+/// \brief Implementation of the EventSeeder class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventSeeder.hh"
+
+#include "Randomize.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventSeeder::Seed(G4int runID, G4long eventIndex) const
+{
+  auto index = std::uint64_t(eventIndex);
+  SetSeeds(Philox({ std::uint32_t(index), std::uint32_t(runID),
+                    std::uint32_t(index >> 32), 0 },
+                  { std::uint32_t(fMasterSeed),
+                    std::uint32_t(fMasterSeed >> 32) }));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventSeeder::SetSeeds(const std::array<std::uint32_t, 4>& words)
+{
+  // positive and non-zero: some engines stop reading seeds at 0
+  long seeds[5] = { 0, 0, 0, 0, 0 };
+  for(G4int i = 0; i < 4; ++i)
+  {
+    seeds[i] = long(words[i] & 0x7fffffffu);
+    if(seeds[i] == 0)
+      seeds[i] = 1;
+  }
+  G4Random::setTheSeeds(seeds, 4);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::array<std::uint32_t, 4> EventSeeder::Philox(
+  std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key)
+{
+  const std::uint64_t kMul0 = 0xD2511F53u, kMul1 = 0xCD9E8D57u;
+  const std::uint32_t kWeyl0 = 0x9E3779B9u, kWeyl1 = 0xBB67AE85u;
+  for(G4int round = 0; round < 10; ++round)
+  {
+    if(round > 0)
+    {
+      key[0] += kWeyl0;
+      key[1] += kWeyl1;
+    }
+    std::uint64_t p0 = kMul0 * counter[0];
+    std::uint64_t p1 = kMul1 * counter[2];
+    counter = { std::uint32_t(p1 >> 32) ^ counter[1] ^ key[0],
+                std::uint32_t(p1), std::uint32_t(p0 >> 32) ^ counter[3] ^ key[1],
+                std::uint32_t(p0) };
+  }
+  return counter;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::uint64_t EventSeeder::Mix(std::uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
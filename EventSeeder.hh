@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/EventSeeder.hh
+/// \brief Definition of the EventSeeder class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventSeeder_h
+#define EventSeeder_h 1
+
+#include "globals.hh"
+
+#include <array>
+#include <cstdint>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Seeds of an event as a function of (master seed, run ID, event ID)
+/// only, drawn from the counter-based Philox4x32-10 generator (Salmon et
+/// al., SC'11) with the master seed as key and (event, run) as counter.
+///
+/// The engine of the thread processing the event is reseeded before the
+/// primaries are generated, so an event is the same whichever thread runs
+/// it and however events are scheduled. Results then no longer depend on
+/// the number of threads, which the reproducibility digest printed at end
+/// of run checks.
+
+class EventSeeder
+{
+ public:
+  explicit EventSeeder(std::uint64_t masterSeed) : fMasterSeed(masterSeed) {}
+  ~EventSeeder() = default;
+
+  std::uint64_t GetMasterSeed() const { return fMasterSeed; }
+
+  // reseed the engine of the calling thread; the event index is global to
+  // all shards of a run (see Shard), the event ID when not sharded
+  void Seed(G4int runID, G4long eventIndex) const;
+
+  static std::array<std::uint32_t, 4> Philox(
+    std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key);
+  // reseed the engine of the calling thread with four Philox words
+  static void SetSeeds(const std::array<std::uint32_t, 4>& words);
+  // 64-bit finalizer of SplitMix64, for digests
+  static std::uint64_t Mix(std::uint64_t x);
+
+ private:
+  std::uint64_t fMasterSeed;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
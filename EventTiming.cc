@@ -0,0 +1,215 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/EventTiming.cc
+/// \brief Implementation of the EventTiming class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventTiming.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+G4bool Faster(const SlowEvent& a, const SlowEvent& b)
+{
+  return a.fWallTime > b.fWallTime;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+EventTiming::EventTiming(G4int slowest)
+  : fMaxSlowest(slowest)
+  , fBins(kBinsPerDecade * kDecades + 2, 0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTiming::FillTime(G4double wallTime)
+{
+  G4double u = kBinsPerDecade * std::log10(wallTime / kMinTime);
+  G4int bin  = u < 0. ? 0 : std::min(G4int(u) + 1, (G4int) fBins.size() - 1);
+  fBins[bin] += 1.;
+  fEvents += 1.;
+  fSum += wallTime;
+  fMax = std::max(fMax, wallTime);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTiming::Fill(const SlowEvent& event)
+{
+  FillTime(event.fWallTime);
+  Keep(event);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTiming::Keep(const SlowEvent& event)
+{
+  if(!IsSlow(event.fWallTime))
+    return;
+  if((G4int) fSlowest.size() == fMaxSlowest)
+  {
+    std::pop_heap(fSlowest.begin(), fSlowest.end(), Faster);
+    fSlowest.pop_back();
+  }
+  fSlowest.push_back(event);
+  std::push_heap(fSlowest.begin(), fSlowest.end(), Faster);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTiming::Add(const EventTiming& other)
+{
+  for(std::size_t i = 0; i < fBins.size(); ++i)
+    fBins[i] += other.fBins[i];
+  fEvents += other.fEvents;
+  fSum += other.fSum;
+  fMax = std::max(fMax, other.fMax);
+  for(const auto& event : other.fSlowest)
+    Keep(event);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTiming::Print() const
+{
+  if(fEvents == 0.)
+    return;
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec              = G4cout.precision(3);
+
+  G4cout << "\n-------- Event wall time (" << (G4long) fEvents
+         << " events) --------" << G4endl;
+  G4cout << "Mean " << fSum / fEvents << " s, max " << fMax << " s" << G4endl;
+  G4cout << std::left << std::setw(24) << "time [s]" << std::right
+         << std::setw(10) << "events" << std::setw(12) << "time [%]"
+         << G4endl;
+  // bin i covers [edge(i - 1), edge(i)); the time share uses its centre
+  auto edge = [](G4double k) {
+    return kMinTime * std::pow(10., k / kBinsPerDecade);
+  };
+  std::size_t n = fBins.size();
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    if(fBins[i] == 0.)
+      continue;
+    std::ostringstream range;
+    range << std::setprecision(3);
+    if(i == 0)
+      range << "< " << kMinTime;
+    else if(i == n - 1)
+      range << ">= " << edge(n - 2.);
+    else
+      range << edge(i - 1.) << " - " << edge(G4double(i));
+    G4double centre = i == 0 ? kMinTime : edge(i - 0.5);
+    G4cout << std::left << std::setw(24) << range.str() << std::right
+           << std::setw(10) << (G4long) fBins[i] << std::setw(12)
+           << 100. * fBins[i] * centre / fSum << G4endl;
+  }
+
+  auto slowest = fSlowest;
+  std::sort_heap(slowest.begin(), slowest.end(), Faster);
+  if(!slowest.empty())
+  {
+    G4cout << "Slowest events:" << G4endl;
+    for(const auto& event : slowest)
+    {
+      G4cout << "  event " << event.fEventID << ": " << event.fWallTime
+             << " s, " << event.fPrimaries << " x " << event.fParticle << " "
+             << G4BestUnit(event.fEnergy, "Energy") << G4endl;
+    }
+  }
+
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTiming::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if(!out)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open " << fileName << " for writing.";
+    G4Exception("EventTiming::Write", "OpNovice2_013", JustWarning, ed);
+    return;
+  }
+  auto slowest = fSlowest;
+  std::sort_heap(slowest.begin(), slowest.end(), Faster);
+  out << std::setprecision(17);
+  for(const auto& event : slowest)
+  {
+    out << "event " << event.fEventID << " " << event.fWallTime << " "
+        << event.fParticle << " " << event.fEnergy / MeV << " "
+        << event.fPosition.x() / mm << " " << event.fPosition.y() / mm << " "
+        << event.fPosition.z() / mm << " " << event.fDirection.x() << " "
+        << event.fDirection.y() << " " << event.fDirection.z() << " "
+        << event.fPrimaries << " " << event.fRandomStatus.size() << "\n"
+        << event.fRandomStatus << "\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::vector<SlowEvent> EventTiming::Read(const G4String& fileName)
+{
+  std::vector<SlowEvent> events;
+  std::ifstream in(fileName);
+  G4String tag;
+  while(in >> tag && tag == "event")
+  {
+    SlowEvent event;
+    G4double x, y, z, u, v, w;
+    std::size_t length = 0;
+    in >> event.fEventID >> event.fWallTime >> event.fParticle >>
+      event.fEnergy >> x >> y >> z >> u >> v >> w >> event.fPrimaries >>
+      length;
+    in.get();  // end of line
+    event.fRandomStatus.resize(length);
+    if(!in || !in.read(&event.fRandomStatus[0], length))
+      break;
+    event.fEnergy *= MeV;
+    event.fPosition.set(x * mm, y * mm, z * mm);
+    event.fDirection.set(u, v, w);
+    events.push_back(event);
+  }
+  if(events.empty())
+  {
+    G4ExceptionDescription ed;
+    ed << "No events read from " << fileName << ".";
+    G4Exception("EventTiming::Read", "OpNovice2_021", JustWarning, ed);
+  }
+  return events;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
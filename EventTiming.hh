@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/EventTiming.hh
+/// \brief Definition of the EventTiming class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventTiming_h
+#define EventTiming_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// One of the slowest events of a run: what is needed to replay it.
+struct SlowEvent
+{
+  G4int fEventID = 0;
+  G4double fWallTime = 0.;  // s
+  G4String fParticle;  // first primary
+  G4double fEnergy = 0.;
+  G4ThreeVector fPosition;
+  G4ThreeVector fDirection;
+  G4int fPrimaries = 0;
+  G4String fRandomStatus;  // engine state before primary generation
+};
+
+/// Wall time per event in a log-binned histogram (10 bins per decade,
+/// 1 us to 10^4 s, plus under- and overflow), and the slowest events with
+/// the random-engine state they started from, so that each can be run
+/// again alone (/opnovice2/gun/replay). Each thread fills its own copy in
+/// its Run; copies are added in Run::Merge.
+
+class EventTiming
+{
+ public:
+  explicit EventTiming(G4int slowest);
+  ~EventTiming() = default;
+
+  void Fill(const SlowEvent& event);
+  // cheap test first: most events are faster than the slowest kept ones
+  G4bool IsSlow(G4double wallTime) const
+  {
+    return fMaxSlowest > 0 && ((G4int) fSlowest.size() < fMaxSlowest ||
+                               wallTime > fSlowest.front().fWallTime);
+  }
+  void FillTime(G4double wallTime);
+
+  void Add(const EventTiming& other);
+  void Print() const;
+  // the slowest events, slowest first, in the format read by Read()
+  void Write(const G4String& fileName) const;
+  static std::vector<SlowEvent> Read(const G4String& fileName);
+
+ private:
+  void Keep(const SlowEvent& event);
+
+  static constexpr G4int kBinsPerDecade = 10;
+  static constexpr G4int kDecades = 10;
+  static constexpr G4double kMinTime = 1.e-6;  // s
+
+  G4int fMaxSlowest;
+  std::vector<G4double> fBins;  // [0] underflow, [n + 1] overflow
+  G4double fEvents = 0.;
+  G4double fSum = 0.;
+  G4double fMax = 0.;
+  std::vector<SlowEvent> fSlowest;  // min-heap on fWallTime
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
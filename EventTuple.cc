@@ -0,0 +1,150 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/EventTuple.cc
+/// \brief Implementation of the EventTuple class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventTuple.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <cstring>
+
+namespace
+{
+const char kTupleMagic[8] = { 'O', 'P', 'N', '2', 'T', 'U', 'P', 'L' };
+const std::size_t kChunkRows = std::size_t(1) << 16;
+
+std::uint32_t Word(std::int32_t value)
+{
+  return std::uint32_t(value);
+}
+
+std::uint32_t Word(G4double value)
+{
+  float f = float(value);
+  std::uint32_t w;
+  std::memcpy(&w, &f, sizeof(w));
+  return w;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+EventTuple* EventTuple::Instance()
+{
+  static EventTuple instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+EventTuple::~EventTuple()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTuple::Open(const G4String& fileName, G4bool compress)
+{
+  Close();
+  G4AutoLock lock(&fMutex);
+  if(!fFile.Open(fileName, kTupleMagic, sizeof(std::uint32_t), compress))
+    return;
+  fRowGroups = 0;
+  fRows      = 0;
+  fOpen.store(true, std::memory_order_release);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTuple::Close()
+{
+  if(!fOpen.exchange(false))
+    return;
+  G4AutoLock lock(&fMutex);
+  fFile.Close();
+  G4cout << "Event tuple: " << fRows << " events in " << fRowGroups
+         << " row groups (" << fFile.GetBytesWritten() / 1024 << " kB)"
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+EventTuple::Chunk& EventTuple::GetLocalChunk()
+{
+  static G4ThreadLocal Chunk* chunk = nullptr;
+  if(!chunk)
+  {
+    chunk = new Chunk;
+    for(auto& column : *chunk)
+      column.reserve(kChunkRows);
+  }
+  return *chunk;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTuple::Fill(const EventRecord& record, G4double depth)
+{
+  Chunk& chunk = GetLocalChunk();
+  chunk[kEventID].push_back(Word(record.fEventID));
+  chunk[kEnergy].push_back(Word(record.fEnergy / keV));
+  chunk[kScintillation].push_back(Word(record.fScintillation));
+  chunk[kDetected].push_back(Word(record.fDetected));
+  chunk[kEdep].push_back(Word(record.fEdep / keV));
+  chunk[kDepth].push_back(Word(depth < 0. ? -1. : depth / mm));
+  if(chunk[kEventID].size() >= kChunkRows)
+    WriteChunk(chunk);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTuple::FlushThread()
+{
+  Chunk& chunk = GetLocalChunk();
+  if(IsOpen())
+    WriteChunk(chunk);
+  for(auto& column : chunk)
+    column.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void EventTuple::WriteChunk(Chunk& chunk)
+{
+  auto nRows = std::uint32_t(chunk[kEventID].size());
+  if(nRows > 0)
+  {
+    // one lock per 64k events; compression happens inside it, which keeps
+    // the columns of a row group together in the file
+    G4AutoLock lock(&fMutex);
+    for(G4int i = 0; i < kNumberOfColumns; ++i)
+      fFile.WriteBlock(chunk[i].data(), nRows, i, fRowGroups);
+    ++fRowGroups;
+    fRows += nRows;
+  }
+  for(auto& column : chunk)
+    column.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/EventTuple.hh
+/// \brief Definition of the EventTuple class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventTuple_h
+#define EventTuple_h 1
+
+#include "BlockFile.hh"
+#include "EventAction.hh"
+#include "G4AutoLock.hh"
+
+#include <array>
+#include <atomic>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Per-event summary ntuple, stored by column.
+///
+/// Every worker fills its own chunk of 65536 rows, one array per column.
+/// A full chunk is written as one row group: each column becomes a block
+/// of a BlockFile (magic "OPN2TUPL", 4-byte records, zlib optional) whose
+/// index key range is (column, row group). Reading one column of a large
+/// run is then a handful of sequential reads and inflates.
+/// Rows of different threads interleave; sort by event ID if needed.
+
+class EventTuple
+{
+ public:
+  enum Column
+  {
+    kEventID,  // int32
+    kEnergy,  // float, primary energy [keV]
+    kScintillation,  // int32, photons created
+    kDetected,  // int32, photons detected at the photodiode
+    kEdep,  // float, energy deposited in the scintillator [keV]
+    kDepth,  // float, depth of the first deposit [mm], -1 if none
+    kNumberOfColumns
+  };
+
+  static EventTuple* Instance();
+
+  // master thread, around the event loop
+  void Open(const G4String& fileName, G4bool compress);
+  void Close();
+  G4bool IsOpen() const { return fOpen.load(std::memory_order_acquire); }
+
+  // worker threads
+  void Fill(const EventRecord& record, G4double depth);
+  // writes this thread's partial chunk; call at end of run
+  void FlushThread();
+
+ private:
+  using Chunk = std::array<std::vector<std::uint32_t>, kNumberOfColumns>;
+
+  EventTuple() = default;
+  ~EventTuple();
+
+  Chunk& GetLocalChunk();
+  void WriteChunk(Chunk& chunk);
+
+  std::atomic<G4bool> fOpen{ false };
+  G4Mutex fMutex;
+  BlockFileWriter fFile;
+  std::int32_t fRowGroups = 0;
+  std::uint64_t fRows = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,130 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/Histo2D.cc
+/// \brief Implementation of the Histo2D class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Histo2D.hh"
+
+#include "RunState.hh"
+
+#include <algorithm>
+#include <numeric>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Histo2D::Configure(G4int nx, G4double xmin, G4double xmax, G4int ny,
+                        G4double ymin, G4double ymax)
+{
+  fNx     = nx;
+  fNy     = ny;
+  fXmin   = xmin;
+  fXmax   = xmax;
+  fYmin   = ymin;
+  fYmax   = ymax;
+  fXscale = nx / (xmax - xmin);
+  fYscale = ny / (ymax - ymin);
+  fBins.assign(std::size_t(nx) * ny, 0.);
+  fOutside = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Histo2D::Add(const Histo2D& other)
+{
+  if(!other.IsConfigured())
+    return;
+  if(!IsConfigured())
+  {
+    *this = other;
+    return;
+  }
+  if(other.fBins.size() != fBins.size())
+  {
+    G4Exception("Histo2D::Add", "OpNovice2_014", JustWarning,
+                "Cannot add 2D histograms with different binning.");
+    return;
+  }
+  for(std::size_t i = 0; i < fBins.size(); ++i)
+    fBins[i] += other.fBins[i];
+  fOutside += other.fOutside;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Histo2D::Reset()
+{
+  std::fill(fBins.begin(), fBins.end(), 0.);
+  fOutside = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Histo2D::Save(StateWriter& out) const
+{
+  out.Put(fNx);
+  out.Put(fNy);
+  out.Put(fXmin);
+  out.Put(fXmax);
+  out.Put(fYmin);
+  out.Put(fYmax);
+  out.Put(fBins);
+  out.Put(fOutside);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool Histo2D::Restore(StateReader& in)
+{
+  G4int nx = 0, ny = 0;
+  G4double xmin = 0., xmax = 0., ymin = 0., ymax = 0., outside = 0.;
+  std::vector<G4double> bins;
+  in.Get(nx);
+  in.Get(ny);
+  in.Get(xmin);
+  in.Get(xmax);
+  in.Get(ymin);
+  in.Get(ymax);
+  in.Get(bins);
+  in.Get(outside);
+  if(!in.Good() || bins.size() != std::size_t(std::max(nx, 0)) * ny)
+    return false;
+  if(bins.empty())
+    *this = Histo2D();
+  else
+  {
+    Configure(nx, xmin, xmax, ny, ymin, ymax);
+    fBins.swap(bins);
+    fOutside = outside;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double Histo2D::GetSum() const
+{
+  return std::accumulate(fBins.begin(), fBins.end(), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
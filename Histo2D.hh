@@ -0,0 +1,114 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/Histo2D.hh
+/// \brief Definition of the Histo2D class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Histo2D_h
+#define Histo2D_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class StateReader;
+class StateWriter;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Dense, fixed-binning 2D histogram for hot loops: filling is a bin
+/// computation and an array increment. Each thread fills its own copy (in
+/// its Run); the copies are added in Run::Merge. Entries outside the range
+/// are only counted.
+
+class Histo2D
+{
+ public:
+  Histo2D() = default;
+  ~Histo2D() = default;
+
+  void Configure(G4int nx, G4double xmin, G4double xmax, G4int ny,
+                 G4double ymin, G4double ymax);
+  G4bool IsConfigured() const { return !fBins.empty(); }
+
+  void Fill(G4double x, G4double y, G4double w = 1.)
+  {
+    G4double u = (x - fXmin) * fXscale;
+    G4double v = (y - fYmin) * fYscale;
+    if(u < 0. || v < 0. || u >= fNx || v >= fNy)
+    {
+      fOutside += w;
+      return;
+    }
+    fBins[G4int(v) * fNx + G4int(u)] += w;
+  }
+
+  void Add(const Histo2D& other);
+  void Reset();
+
+  // binning and contents, for run state files (see RunState)
+  void Save(StateWriter& out) const;
+  G4bool Restore(StateReader& in);
+
+  G4int GetNx() const { return fNx; }
+  G4int GetNy() const { return fNy; }
+  G4double GetXmin() const { return fXmin; }
+  G4double GetXmax() const { return fXmax; }
+  G4double GetYmin() const { return fYmin; }
+  G4double GetYmax() const { return fYmax; }
+  G4double GetBinWidthX() const { return (fXmax - fXmin) / fNx; }
+  G4double GetBinWidthY() const { return (fYmax - fYmin) / fNy; }
+  G4double GetBinCenterX(G4int i) const
+  {
+    return fXmin + (i + 0.5) * GetBinWidthX();
+  }
+  G4double GetBinCenterY(G4int j) const
+  {
+    return fYmin + (j + 0.5) * GetBinWidthY();
+  }
+  G4double GetBinContent(G4int i, G4int j) const { return fBins[j * fNx + i]; }
+  G4double GetSum() const;
+  G4double GetOutside() const { return fOutside; }
+
+ private:
+  G4int fNx = 0;
+  G4int fNy = 0;
+  G4double fXmin = 0.;
+  G4double fXmax = 0.;
+  G4double fYmin = 0.;
+  G4double fYmax = 0.;
+  G4double fXscale = 0.;  // bins per unit length
+  G4double fYscale = 0.;
+  std::vector<G4double> fBins;  // row-major, y outer
+  G4double fOutside = 0.;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -135,4 +135,20 @@ void HistoManager::Book()
   {
     analysisMan->SetH1Activation(i, false);
   }
+
+  // 2D maps [mm], filled through dense per-thread arrays in Run
+  // Default binning: 1 um over the photodiode face
+  G4int n2    = 48;
+  G4double xy = 0.024;
+  // 0
+  analysisMan->CreateH2("PD hits", "detected photon position on the PD", n2,
+                        -xy, xy, n2, -xy, xy);
+  // 1
+  analysisMan->CreateH2("Entrance", "primary entrance point into CsI", n2,
+                        -xy, xy, n2, -xy, xy);
+
+  for(G4int i = 0; i < analysisMan->GetNofH2s(); ++i)
+  {
+    analysisMan->SetH2Activation(i, false);
+  }
 }
@@ -30,8 +30,12 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "ActionInitialization.hh"
+#include "Benchmark.hh"
+#include "Checkpoint.hh"
 #include "DetectorConstruction.hh"
+#include "Shard.hh"
 #include "SteppingVerbose.hh"
+#include "SweepServer.hh"
 
 // Include the implementation directly to avoid linker issues
 #include "src/CustomOpticalPhysics.cc"  // Full path from project root
@@ -47,19 +51,56 @@
 #include "G4OpticalPhoton.hh"
 #include "G4ProcessManager.hh"
 
+#include <cstdlib>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 int main(int argc, char** argv)
 {
-  // detect interactive mode (if no arguments) and define UI session
+  // start the clock for the initialization time of benchmark reports
+  Benchmark::Instance();
+
+  // OpNovice2 [--shard i/N] [--resume] [--sweep JOBS [--jobs J]] [macro]
+  G4String macro;
+  G4String sweep;
+  G4int jobs = 0;
+  for(G4int i = 1; i < argc; ++i)
+  {
+    G4String arg = argv[i];
+    G4bool usage = false;
+    if(arg == "--shard")
+      usage = i + 1 == argc || !Shard::Instance()->Parse(argv[++i]);
+    else if(arg == "--resume")
+      Checkpoint::Instance()->SetResume(true);
+    else if(arg == "--sweep")
+    {
+      usage = i + 1 == argc;
+      if(!usage)
+        sweep = argv[++i];
+    }
+    else if(arg == "--jobs")
+      usage = i + 1 == argc || (jobs = std::atoi(argv[++i])) < 1;
+    else
+      macro = arg;
+    if(usage)
+    {
+      G4cerr << "usage: " << argv[0] << " [--shard i/N] [--resume]"
+             << " [--sweep JOBS [--jobs J]] [macro]" << G4endl;
+      return 1;
+    }
+  }
+
+  // detect interactive mode (if no macro) and define UI session
   G4UIExecutive* ui = nullptr;
-  if(argc == 1)
+  if(macro.empty() && sweep.empty())
     ui = new G4UIExecutive(argc, argv);
 
   // application-specific SteppingVerbose
   auto steppingVerbose = new SteppingVerbose;
 
-  auto runManager = G4RunManagerFactory::CreateRunManager();
+  // the sweep forks the process, and threads do not survive fork
+  auto runManager = G4RunManagerFactory::CreateRunManager(
+    sweep.empty() ? G4RunManagerType::Default : G4RunManagerType::SerialOnly);
   //auto runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::SerialOnly);
 
   auto detector = new DetectorConstruction();
@@ -114,6 +155,7 @@ int main(int argc, char** argv)
 
   // get the pointer to the User Interface manager
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  G4int status = 0;
 
   if(ui)
   {
@@ -125,16 +167,19 @@ int main(int argc, char** argv)
   else
   {
     // batch mode
-    G4String command  = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command + fileName);
+    G4String command = "/control/execute ";
+    if(!macro.empty())
+      UImanager->ApplyCommand(command + macro);
+    // the macro is the setup common to all the jobs
+    if(!sweep.empty())
+      status = SweepServer(sweep, jobs).Run() == 0 ? 0 : 1;
   }
 
   // job termination
   delete visManager;
   delete runManager;
   delete steppingVerbose;
-  return 0;
+  return status;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
\ No newline at end of file
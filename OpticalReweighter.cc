@@ -0,0 +1,185 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/OpticalReweighter.cc
+/// \brief Implementation of the OpticalReweighter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "OpticalReweighter.hh"
+
+#include "RunState.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void OpticalReweighter::SetTargets(std::vector<Target> targets)
+{
+  fTargets = std::move(targets);
+  std::size_t n = fTargets.size();
+  fEventWeight.assign(n, 0.);
+  fSumW.assign(n, 0.);
+  fSumW2.assign(n, 0.);
+  fSumWN.assign(n, 0.);
+  fEventDetected = 0.;
+  fEvents        = 0.;
+  fSumN          = 0.;
+  fSumN2         = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void OpticalReweighter::AddPhoton(const DetectedPhoton& photon)
+{
+  fEventDetected += 1.;
+  for(std::size_t k = 0; k < fTargets.size(); ++k)
+    fEventWeight[k] += fTargets[k].fWeight(photon);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void OpticalReweighter::EndEvent()
+{
+  G4double n = fEventDetected;
+  fEvents += 1.;
+  fSumN += n;
+  fSumN2 += n * n;
+  for(std::size_t k = 0; k < fTargets.size(); ++k)
+  {
+    G4double w = fEventWeight[k];
+    fSumW[k] += w;
+    fSumW2[k] += w * w;
+    fSumWN[k] += w * n;
+    fEventWeight[k] = 0.;
+  }
+  fEventDetected = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void OpticalReweighter::Add(const OpticalReweighter& other)
+{
+  if(!other.IsActive())
+    return;
+  if(!IsActive())
+    SetTargets(other.fTargets);
+
+  fEvents += other.fEvents;
+  fSumN += other.fSumN;
+  fSumN2 += other.fSumN2;
+  for(std::size_t k = 0; k < fTargets.size(); ++k)
+  {
+    fSumW[k] += other.fSumW[k];
+    fSumW2[k] += other.fSumW2[k];
+    fSumWN[k] += other.fSumWN[k];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void OpticalReweighter::Save(StateWriter& out) const
+{
+  out.Put(std::uint64_t(fTargets.size()));
+  for(const auto& target : fTargets)
+    out.Put(target.fName);
+  out.Put(fEvents);
+  out.Put(fSumN);
+  out.Put(fSumN2);
+  out.Put(fSumW);
+  out.Put(fSumW2);
+  out.Put(fSumWN);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool OpticalReweighter::Restore(StateReader& in)
+{
+  std::uint64_t n = 0;
+  in.Get(n);
+  std::vector<Target> targets;
+  for(std::uint64_t k = 0; k < n && in.Good(); ++k)
+  {
+    G4String name;
+    in.Get(name);
+    targets.push_back({ name, nullptr });
+  }
+  SetTargets(std::move(targets));
+  in.Get(fEvents);
+  in.Get(fSumN);
+  in.Get(fSumN2);
+  in.Get(fSumW);
+  in.Get(fSumW2);
+  in.Get(fSumWN);
+  return in.Good() && fSumW.size() == n && fSumW2.size() == n &&
+         fSumWN.size() == n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void OpticalReweighter::Print() const
+{
+  if(!IsActive() || fEvents < 2.)
+    return;
+
+  G4double meanN = fSumN / fEvents;
+  G4double varN  = fSumN2 / fEvents - meanN * meanN;
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec              = G4cout.precision(4);
+
+  G4cout << "\n-------- Optical reweighting (" << (G4long) fEvents
+         << " events) --------" << G4endl;
+  G4cout << "Simulated: " << meanN << " +- "
+         << std::sqrt(std::max(varN, 0.) / fEvents)
+         << " detected photons per event" << G4endl;
+  G4cout << std::left << std::setw(24) << "target" << std::setw(26)
+         << "detected per event" << "ratio to simulated" << G4endl;
+  for(std::size_t k = 0; k < fTargets.size(); ++k)
+  {
+    G4double meanW = fSumW[k] / fEvents;
+    G4double varW  = fSumW2[k] / fEvents - meanW * meanW;
+    G4double cov   = fSumWN[k] / fEvents - meanW * meanN;
+    G4double errW  = std::sqrt(std::max(varW, 0.) / fEvents);
+
+    // ratio of means, delta method with the event-level covariance
+    G4double ratio    = meanN > 0. ? meanW / meanN : 0.;
+    G4double ratioErr = 0.;
+    if(meanN > 0.)
+    {
+      G4double var = varW - 2. * ratio * cov + ratio * ratio * varN;
+      ratioErr     = std::sqrt(std::max(var, 0.) / fEvents) / meanN;
+    }
+
+    std::ostringstream tally;
+    tally << meanW << " +- " << errW;
+    G4cout << std::left << std::setw(24) << fTargets[k].fName
+           << std::setw(26) << tally.str() << ratio << " +- " << ratioErr
+           << G4endl;
+  }
+
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
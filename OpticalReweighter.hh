@@ -0,0 +1,110 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/OpticalReweighter.hh
+/// \brief Definition of the OpticalReweighter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef OpticalReweighter_h
+#define OpticalReweighter_h 1
+
+#include "globals.hh"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class StateReader;
+class StateWriter;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// History of a detected photon, as needed by the reweighting targets.
+struct DetectedPhoton
+{
+  G4int fWrapReflections = 0;  // reflections on the ReflectiveWrap skin
+  G4double fPathLength = 0.;  // total path length inside the CsI
+  G4double fEnergy = 0.;  // photon energy
+};
+
+/// Reweighting of detected photons to other optical parameters.
+///
+/// Each target gives a photon the ratio of the probability of its history
+/// under the target parameters to the one under the simulated parameters,
+/// e.g. (R / R_sim)^n for a wrap reflectivity R and n wrap reflections,
+/// or exp(L / lambda_sim - L / lambda) for an absorption length lambda(E)
+/// and a path length L in the CsI.
+/// The weights are summed per event; all targets use the same events, so
+/// their ratios to the simulated tally have much smaller errors than the
+/// tallies themselves (the covariance is taken into account).
+
+class OpticalReweighter
+{
+ public:
+  struct Target
+  {
+    G4String fName;
+    std::function<G4double(const DetectedPhoton&)> fWeight;
+  };
+
+  OpticalReweighter() = default;
+  ~OpticalReweighter() = default;
+
+  void SetTargets(std::vector<Target> targets);
+  G4bool IsActive() const { return !fTargets.empty(); }
+
+  // worker threads, for every detected photon and at end of event
+  void AddPhoton(const DetectedPhoton& photon);
+  void EndEvent();
+
+  void Add(const OpticalReweighter& other);
+  void Print() const;
+
+  // target names and sums, for run state files (see RunState); restored
+  // targets only print, they have no weight function
+  void Save(StateWriter& out) const;
+  G4bool Restore(StateReader& in);
+
+ private:
+  std::vector<Target> fTargets;
+
+  // current event: detected photons, weight sum per target
+  G4double fEventDetected = 0.;
+  std::vector<G4double> fEventWeight;
+
+  G4double fEvents = 0.;
+  G4double fSumN = 0.;
+  G4double fSumN2 = 0.;
+  std::vector<G4double> fSumW;
+  std::vector<G4double> fSumW2;
+  std::vector<G4double> fSumWN;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
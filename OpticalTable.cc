@@ -0,0 +1,124 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/OpticalTable.cc
+/// \brief Implementation of the OpticalTable class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "OpticalTable.hh"
+
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+G4Mutex tableMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::shared_ptr<const OpticalTable> OpticalTable::Load(
+  const G4String& fileName, G4double xUnit, G4double yUnit)
+{
+  using Key = std::tuple<G4String, G4double, G4double>;
+  static std::map<Key, std::shared_ptr<const OpticalTable>> cache;
+
+  G4AutoLock lock(&tableMutex);
+  Key key(fileName, xUnit, yUnit);
+  auto it = cache.find(key);
+  if(it != cache.end())
+    return it->second;
+
+  std::vector<G4double> x;
+  std::vector<G4double> y;
+  std::ifstream in(fileName);
+  std::string line;
+  while(std::getline(in, line))
+  {
+    auto first = line.find_first_not_of(" \t\r");
+    if(first == std::string::npos || line[first] == '#')
+      continue;
+    std::istringstream is(line);
+    G4double a = 0.;
+    G4double b = 0.;
+    if(is >> a >> b)
+    {
+      x.push_back(a * xUnit);
+      y.push_back(b * yUnit);
+    }
+  }
+  if(x.empty())
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot read a two-column table from " << fileName;
+    G4Exception("OpticalTable::Load", "OpNovice2_019", FatalException, ed);
+    return nullptr;
+  }
+
+  auto table   = std::make_shared<OpticalTable>(x, y);
+  table->fName = fileName;
+  cache[key]   = table;
+  G4cout << "Optical table " << fileName << ": " << x.size() << " points"
+         << G4endl;
+  return table;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+OpticalTable::OpticalTable(const std::vector<G4double>& x,
+                           const std::vector<G4double>& y)
+{
+  // sort by x, the files may list wavelengths in decreasing order
+  std::vector<std::size_t> order(x.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&x](std::size_t a, std::size_t b) { return x[a] < x[b]; });
+  for(std::size_t i : order)
+  {
+    fX.push_back(x[i]);
+    fY.push_back(y[i]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double OpticalTable::Value(G4double x) const
+{
+  if(x <= fX.front())
+    return fY.front();
+  if(x >= fX.back())
+    return fY.back();
+  std::size_t i = std::upper_bound(fX.begin(), fX.end(), x) - fX.begin();
+  G4double f    = (x - fX[i - 1]) / (fX[i] - fX[i - 1]);
+  return fY[i - 1] + f * (fY[i] - fY[i - 1]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,71 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/OpticalTable.hh
+/// \brief Definition of the OpticalTable class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef OpticalTable_h
+#define OpticalTable_h 1
+
+#include "globals.hh"
+
+#include <memory>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Two-column text table y(x) for optical reweighting, e.g. absorption
+/// length versus photon energy. Lines starting with '#' are ignored; the
+/// columns are multiplied by the units given to Load(). Values are linear
+/// between the points and constant beyond the first and last one.
+/// Tables are immutable and cached, so all threads share one copy.
+
+class OpticalTable
+{
+ public:
+  static std::shared_ptr<const OpticalTable> Load(const G4String& fileName,
+                                                  G4double xUnit,
+                                                  G4double yUnit);
+
+  OpticalTable(const std::vector<G4double>& x,
+               const std::vector<G4double>& y);
+  ~OpticalTable() = default;
+
+  G4double Value(G4double x) const;
+  const G4String& GetName() const { return fName; }
+
+ private:
+  G4String fName;
+  std::vector<G4double> fX;
+  std::vector<G4double> fY;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,210 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PhaseSpaceFile.cc
+/// \brief Implementation of the PhaseSpaceFile class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhaseSpaceFile.hh"
+
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+G4Mutex phaseSpaceMutex = G4MUTEX_INITIALIZER;
+
+const char kPhaseSpaceMagic[8] = { 'O', 'P', 'N', '2', 'P', 'H', 'S', 'P' };
+const std::uint32_t kPhaseSpaceVersion = 1;
+const std::size_t kPhaseSpaceHeaderSize = 32;
+
+struct PhaseSpaceHeader
+{
+  char fMagic[8];
+  std::uint32_t fVersion;
+  std::uint32_t fRecordSize;
+  std::uint64_t fNumberOfRecords;
+  std::uint64_t fReserved;
+};
+static_assert(sizeof(PhaseSpaceHeader) == kPhaseSpaceHeaderSize,
+              "unexpected phase-space header size");
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::shared_ptr<const PhaseSpaceFile> PhaseSpaceFile::Open(
+  const G4String& fileName)
+{
+  // one mapping per file for the whole process
+  static std::map<G4String, std::shared_ptr<const PhaseSpaceFile>> cache;
+
+  G4AutoLock lock(&phaseSpaceMutex);
+  auto it = cache.find(fileName);
+  if(it != cache.end())
+    return it->second;
+
+  auto file = std::make_shared<PhaseSpaceFile>(fileName);
+  if(!file->IsValid())
+    return nullptr;
+  cache[fileName] = file;
+
+  G4cout << "Phase-space file " << fileName << ": "
+         << file->GetNumberOfRecords() << " records" << G4endl;
+
+  // no tally reads track weights: a weighted beam would be simulated as
+  // an unweighted one
+  std::uint64_t weighted = 0;
+  for(std::uint64_t i = 0; i < file->GetNumberOfRecords(); ++i)
+  {
+    if(file->GetRecord(i).fWeight != 1.f)
+      ++weighted;
+  }
+  if(weighted > 0)
+  {
+    G4ExceptionDescription ed;
+    ed << weighted << " of " << file->GetNumberOfRecords() << " records of "
+       << fileName << " have a weight other than 1. The results are not "
+       << "weighted: every record counts as one particle.";
+    G4Exception("PhaseSpaceFile::Open", "OpNovice2_025", JustWarning, ed);
+  }
+  return file;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+PhaseSpaceFile::PhaseSpaceFile(const G4String& fileName)
+  : fName(fileName)
+{
+#ifdef _WIN32
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  LARGE_INTEGER size;
+  if(file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size))
+  {
+    fFileHandle = file;
+    fMappedSize = std::size_t(size.QuadPart);
+    fMapHandle =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(fMapHandle)
+      fMapping = MapViewOfFile(fMapHandle, FILE_MAP_READ, 0, 0, 0);
+  }
+#else
+  int fd = open(fileName.c_str(), O_RDONLY);
+  struct stat st;
+  if(fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    fMappedSize = std::size_t(st.st_size);
+    void* addr  = mmap(nullptr, fMappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    if(addr != MAP_FAILED)
+    {
+      fMapping = addr;
+      // let the kernel read ahead aggressively
+      madvise(fMapping, fMappedSize, MADV_SEQUENTIAL);
+    }
+  }
+  // the mapping stays valid after the descriptor is closed
+  if(fd >= 0)
+    close(fd);
+#endif
+
+  G4ExceptionDescription ed;
+  if(!fMapping)
+  {
+    ed << "Cannot map phase-space file " << fileName;
+    G4Exception("PhaseSpaceFile::PhaseSpaceFile", "OpNovice2_010",
+                FatalException, ed);
+    return;
+  }
+
+  PhaseSpaceHeader header;
+  std::memset(&header, 0, sizeof(header));
+  if(fMappedSize >= kPhaseSpaceHeaderSize)
+    std::memcpy(&header, fMapping, sizeof(header));
+  std::uint64_t available =
+    (fMappedSize - std::min(fMappedSize, kPhaseSpaceHeaderSize)) /
+    sizeof(PhaseSpaceRecord);
+  if(std::memcmp(header.fMagic, kPhaseSpaceMagic, sizeof(header.fMagic)) !=
+       0 ||
+     header.fVersion != kPhaseSpaceVersion ||
+     header.fRecordSize != sizeof(PhaseSpaceRecord) ||
+     header.fNumberOfRecords > available || header.fNumberOfRecords == 0)
+  {
+    ed << fileName << " is not a valid phase-space file (version "
+       << kPhaseSpaceVersion << ", " << sizeof(PhaseSpaceRecord)
+       << "-byte records).";
+    G4Exception("PhaseSpaceFile::PhaseSpaceFile", "OpNovice2_011",
+                FatalException, ed);
+    return;
+  }
+
+  fNumberOfRecords = header.fNumberOfRecords;
+  fRecords         = reinterpret_cast<const PhaseSpaceRecord*>(
+    static_cast<const char*>(fMapping) + kPhaseSpaceHeaderSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+PhaseSpaceFile::~PhaseSpaceFile()
+{
+#ifdef _WIN32
+  if(fMapping)
+    UnmapViewOfFile(fMapping);
+  if(fMapHandle)
+    CloseHandle(fMapHandle);
+  if(fFileHandle)
+    CloseHandle(fFileHandle);
+#else
+  if(fMapping)
+    munmap(fMapping, fMappedSize);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PhaseSpaceFile::GetSlice(G4int i, G4int n, std::uint64_t& first,
+                              std::uint64_t& last) const
+{
+  if(n < 1)
+    n = 1;
+  if(i < 0 || i >= n)
+    i = 0;
+  first = fNumberOfRecords * std::uint64_t(i) / std::uint64_t(n);
+  last  = fNumberOfRecords * std::uint64_t(i + 1) / std::uint64_t(n);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
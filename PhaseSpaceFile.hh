@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PhaseSpaceFile.hh
+/// \brief Definition of the PhaseSpaceFile class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhaseSpaceFile_h
+#define PhaseSpaceFile_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <memory>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// One particle of a phase-space file. Lengths in mm, energy in MeV.
+struct PhaseSpaceRecord
+{
+  float fPosition[3];
+  float fDirection[3];
+  float fEnergy;
+  float fWeight;
+  float fPolarization[3];
+};
+
+/// Read-only, memory-mapped phase-space file.
+///
+/// Layout: a 32-byte header (magic "OPN2PHSP", uint32 version, uint32
+/// record size, uint64 number of records, 8 bytes reserved) followed by
+/// packed PhaseSpaceRecord entries. The mapping is shared by all threads;
+/// each worker reads its own contiguous slice, so no record is used twice
+/// and no system call is made per record.
+
+class PhaseSpaceFile
+{
+ public:
+  static std::shared_ptr<const PhaseSpaceFile> Open(const G4String& fileName);
+
+  explicit PhaseSpaceFile(const G4String& fileName);
+  ~PhaseSpaceFile();
+
+  PhaseSpaceFile(const PhaseSpaceFile&) = delete;
+  PhaseSpaceFile& operator=(const PhaseSpaceFile&) = delete;
+
+  G4bool IsValid() const { return fRecords != nullptr; }
+  std::uint64_t GetNumberOfRecords() const { return fNumberOfRecords; }
+  const PhaseSpaceRecord& GetRecord(std::uint64_t i) const
+  {
+    return fRecords[i];
+  }
+  const G4String& GetName() const { return fName; }
+
+  // half-open record range [first, last) read by slice i out of n
+  void GetSlice(G4int i, G4int n, std::uint64_t& first,
+                std::uint64_t& last) const;
+
+ private:
+  G4String fName;
+  void* fMapping = nullptr;
+  std::size_t fMappedSize = 0;
+#ifdef _WIN32
+  void* fFileHandle = nullptr;
+  void* fMapHandle = nullptr;
+#endif
+  const PhaseSpaceRecord* fRecords = nullptr;
+  std::uint64_t fNumberOfRecords = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
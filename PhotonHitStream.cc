@@ -0,0 +1,206 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PhotonHitStream.cc
+/// \brief Implementation of the PhotonHitStream class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhotonHitStream.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+namespace
+{
+const char kHitMagic[8] = { 'O', 'P', 'N', '2', 'H', 'I', 'T', 'S' };
+// 64k hits (2.5 MB) per thread and per block
+const std::size_t kRingSize  = std::size_t(1) << 16;
+const std::size_t kBlockSize = std::size_t(1) << 16;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Single-producer single-consumer ring: the worker advances fHead, the
+/// writer thread fTail. Both counters only grow; the slot is counter % size.
+class PhotonHitStream::Ring
+{
+ public:
+  Ring() : fHits(kRingSize) {}
+
+  G4bool TryPush(const PhotonHit& hit)
+  {
+    std::size_t head = fHead.load(std::memory_order_relaxed);
+    if(head - fTail.load(std::memory_order_acquire) == kRingSize)
+      return false;
+    fHits[head & (kRingSize - 1)] = hit;
+    fHead.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  template<class Out>
+  std::size_t PopAll(Out& out)
+  {
+    std::size_t tail = fTail.load(std::memory_order_relaxed);
+    std::size_t head = fHead.load(std::memory_order_acquire);
+    for(std::size_t i = tail; i != head; ++i)
+      out.push_back(fHits[i & (kRingSize - 1)]);
+    fTail.store(head, std::memory_order_release);
+    return head - tail;
+  }
+
+ private:
+  std::vector<PhotonHit> fHits;
+  alignas(64) std::atomic<std::size_t> fHead{ 0 };
+  alignas(64) std::atomic<std::size_t> fTail{ 0 };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+PhotonHitStream* PhotonHitStream::Instance()
+{
+  static PhotonHitStream instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+PhotonHitStream::~PhotonHitStream()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PhotonHitStream::Open(const G4String& fileName)
+{
+  Close();
+  if(!fFile.Open(fileName, kHitMagic, sizeof(PhotonHit), true))
+    return;
+
+  fBlock.clear();
+  fBlock.reserve(kBlockSize + kRingSize);
+  fStalls = 0;
+  fStop   = false;
+  fWriter = std::thread(&PhotonHitStream::WriterLoop, this);
+  fOpen.store(true, std::memory_order_release);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PhotonHitStream::Close()
+{
+  if(!fOpen.exchange(false))
+    return;
+
+  // the event loop is over: whatever is left in the rings is final
+  fStop = true;
+  fWriter.join();
+  fFile.Close();
+
+  G4cout << "Photon hits written: " << fFile.GetNumberOfRecords() << " ("
+         << fFile.GetBytesWritten() / 1024 << " kB)";
+  if(fStalls > 0)
+    G4cout << ", workers waited " << fStalls << " times for the writer";
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+PhotonHitStream::Ring* PhotonHitStream::GetLocalRing()
+{
+  // rings live as long as the process, so worker threads can keep theirs
+  // from one run to the next
+  static G4ThreadLocal Ring* ring = nullptr;
+  if(!ring)
+  {
+    G4AutoLock lock(&fRingsMutex);
+    fRings.push_back(std::make_unique<Ring>());
+    ring = fRings.back().get();
+  }
+  return ring;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PhotonHitStream::Push(const PhotonHit& hit)
+{
+  Ring* ring = GetLocalRing();
+  if(ring->TryPush(hit))
+    return;
+
+  ++fStalls;
+  while(!ring->TryPush(hit))
+    std::this_thread::yield();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::size_t PhotonHitStream::Drain()
+{
+  // threads may register while we drain, so work on a copy of the list
+  std::vector<Ring*> rings;
+  {
+    G4AutoLock lock(&fRingsMutex);
+    for(const auto& ring : fRings)
+      rings.push_back(ring.get());
+  }
+  std::size_t n = 0;
+  for(auto ring : rings)
+  {
+    n += ring->PopAll(fBlock);
+    if(fBlock.size() >= kBlockSize)
+      FlushBlock();
+  }
+  return n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PhotonHitStream::FlushBlock()
+{
+  if(fBlock.empty())
+    return;
+  // blocks mix threads, so events are not ordered inside a block
+  std::int32_t minEvent = INT_MAX;
+  std::int32_t maxEvent = INT_MIN;
+  for(const auto& hit : fBlock)
+  {
+    minEvent = std::min(minEvent, hit.fEventID);
+    maxEvent = std::max(maxEvent, hit.fEventID);
+  }
+  fFile.WriteBlock(fBlock.data(), std::uint32_t(fBlock.size()), minEvent,
+                   maxEvent);
+  fBlock.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PhotonHitStream::WriterLoop()
+{
+  while(!fStop.load(std::memory_order_acquire))
+  {
+    if(Drain() == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  Drain();
+  FlushBlock();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,111 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PhotonHitStream.hh
+/// \brief Definition of the PhotonHitStream class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhotonHitStream_h
+#define PhotonHitStream_h 1
+
+#include "BlockFile.hh"
+#include "globals.hh"
+#include "G4AutoLock.hh"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// One photon detected at the photodiode. Lengths in mm, time in ns,
+/// wavelength in nm; x, y are in the frame of the photodiode volume.
+struct PhotonHit
+{
+  std::int32_t fEventID;
+  std::int32_t fPixel;  // copy number of the photodiode volume
+  float fX;
+  float fY;
+  float fTime;  // global time of arrival
+  float fWavelength;
+  float fEmission[3];  // where the photon was created
+  std::int32_t fReflections;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Streams every detected photon to a block-compressed file (BlockFile,
+/// magic "OPN2HITS") without making the workers wait for the disk.
+///
+/// Each worker thread appends to its own single-producer ring buffer; a
+/// writer thread started by Open() drains all rings, packs the hits into
+/// blocks and compresses them. The block index keeps the event range of
+/// every block. A worker only waits when its ring is full, i.e. when the
+/// writer cannot keep up at all; such stalls are counted and reported.
+
+class PhotonHitStream
+{
+ public:
+  static PhotonHitStream* Instance();
+
+  // master thread, around the event loop
+  void Open(const G4String& fileName);
+  void Close();
+
+  G4bool IsOpen() const { return fOpen.load(std::memory_order_acquire); }
+  // worker threads
+  void Push(const PhotonHit& hit);
+
+ private:
+  class Ring;
+
+  PhotonHitStream() = default;
+  ~PhotonHitStream();
+
+  Ring* GetLocalRing();
+  std::size_t Drain();
+  void FlushBlock();
+  void WriterLoop();
+
+  std::vector<std::unique_ptr<Ring>> fRings;
+  G4Mutex fRingsMutex;
+
+  std::atomic<G4bool> fOpen{ false };
+  std::atomic<G4bool> fStop{ false };
+  std::atomic<std::uint64_t> fStalls{ 0 };
+  std::thread fWriter;
+
+  // owned by the writer thread while the stream is open
+  BlockFileWriter fFile;
+  std::vector<PhotonHit> fBlock;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,154 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PrecisionMonitor.cc
+/// \brief Implementation of the PrecisionMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PrecisionMonitor.hh"
+
+#include "G4ThreadLocalSingleton.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// a few batches before trusting the variance estimate
+const G4double kMinimumBatches = 3.;
+
+struct LocalStats
+{
+  RunningStats fStats;
+  G4int fGeneration = -1;
+};
+// one per thread, deleted with the singleton at exit
+G4ThreadLocalSingleton<LocalStats> threadStats;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+PrecisionMonitor* PrecisionMonitor::Instance()
+{
+  static PrecisionMonitor instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrecisionMonitor::SetTarget(G4double relativeError,
+                                 Observable observable, G4int batchSize)
+{
+  fTarget     = relativeError;
+  fObservable = observable;
+  fBatchSize  = batchSize;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrecisionMonitor::Reset()
+{
+  G4AutoLock lock(&fMutex);
+  fStats = RunningStats();
+  fStop  = false;
+  // thread-local statistics of the previous run are dropped lazily
+  ++fGeneration;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double PrecisionMonitor::RelativeError(const RunningStats& stats) const
+{
+  if(stats.fN < 2.)
+    return std::numeric_limits<G4double>::infinity();
+  G4double n    = stats.fN;
+  G4double varX = stats.fM2X / (n - 1.);
+  if(fObservable == kDetected)
+  {
+    if(stats.fMeanX <= 0.)
+      return std::numeric_limits<G4double>::infinity();
+    return std::sqrt(varX / n) / stats.fMeanX;
+  }
+
+  // ratio of means: delta method with the covariance of x and y
+  if(stats.fMeanX <= 0. || stats.fMeanY <= 0.)
+    return std::numeric_limits<G4double>::infinity();
+  G4double varY = stats.fM2Y / (n - 1.);
+  G4double cov  = stats.fCXY / (n - 1.);
+  G4double mx   = stats.fMeanX;
+  G4double my   = stats.fMeanY;
+  G4double rel2 =
+    (varX / (mx * mx) + varY / (my * my) - 2. * cov / (mx * my)) / n;
+  return std::sqrt(std::max(rel2, 0.));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool PrecisionMonitor::AddEvent(G4int detected, G4int created)
+{
+  if(fStop.load(std::memory_order_relaxed))
+    return true;
+
+  LocalStats* localStats = threadStats.Instance();
+  G4int generation = fGeneration.load(std::memory_order_relaxed);
+  if(localStats->fGeneration != generation)
+  {
+    localStats->fStats      = RunningStats();
+    localStats->fGeneration = generation;
+  }
+
+  localStats->fStats.Add(detected, created);
+  if(localStats->fStats.fN < fBatchSize)
+    return false;
+
+  G4AutoLock lock(&fMutex);
+  fStats.Merge(localStats->fStats);
+  localStats->fStats = RunningStats();
+  if(fStats.fN >= kMinimumBatches * fBatchSize &&
+     RelativeError(fStats) <= fTarget)
+    fStop = true;
+  return fStop;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrecisionMonitor::Print() const
+{
+  if(!IsActive())
+    return;
+  G4AutoLock lock(&fMutex);
+  G4double value = fObservable == kDetected
+                     ? fStats.fMeanX
+                     : (fStats.fMeanY > 0. ? fStats.fMeanX / fStats.fMeanY
+                                           : 0.);
+  G4cout << "\n-------- Target precision --------" << G4endl;
+  G4cout << (fObservable == kDetected ? "Detected photons per event: "
+                                      : "Detection efficiency: ")
+         << value << ", relative error " << RelativeError(fStats)
+         << " after " << fStats.fN << " events in full batches" << G4endl;
+  G4cout << (fStop ? "Target " : "Target NOT reached: ") << fTarget
+         << (fStop ? " reached, run stopped early." : ", event cap hit.")
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
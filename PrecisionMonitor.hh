@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PrecisionMonitor.hh
+/// \brief Definition of the PrecisionMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PrecisionMonitor_h
+#define PrecisionMonitor_h 1
+
+#include "globals.hh"
+#include "G4AutoLock.hh"
+
+#include <atomic>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Welford running means, variances and covariance of a pair (x, y).
+/// Two sets merge exactly (Chan et al.), so threads can keep their own.
+struct RunningStats
+{
+  G4double fN = 0.;
+  G4double fMeanX = 0.;
+  G4double fMeanY = 0.;
+  G4double fM2X = 0.;
+  G4double fM2Y = 0.;
+  G4double fCXY = 0.;
+
+  void Add(G4double x, G4double y)
+  {
+    fN += 1.;
+    G4double dx = x - fMeanX;
+    fMeanX += dx / fN;
+    G4double dy = y - fMeanY;
+    fMeanY += dy / fN;
+    fM2X += dx * (x - fMeanX);
+    fM2Y += dy * (y - fMeanY);
+    fCXY += dx * (y - fMeanY);
+  }
+
+  void Merge(const RunningStats& other)
+  {
+    if(other.fN == 0.)
+      return;
+    G4double n  = fN + other.fN;
+    G4double dx = other.fMeanX - fMeanX;
+    G4double dy = other.fMeanY - fMeanY;
+    G4double f  = fN * other.fN / n;
+    fM2X += other.fM2X + dx * dx * f;
+    fM2Y += other.fM2Y + dy * dy * f;
+    fCXY += other.fCXY + dx * dy * f;
+    fMeanX += dx * other.fN / n;
+    fMeanY += dy * other.fN / n;
+    fN = n;
+  }
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Stops a run once the chosen observable is known to a target relative
+/// standard error, /run/beamOn giving the maximum number of events.
+///
+/// Workers keep thread-local statistics and fold them into the shared
+/// ones every batch of events; the check is made at that point only, so
+/// the lock is taken once per batch. When the target is reached every
+/// worker aborts its run after the current event.
+///
+/// Observables: "detected", the mean number of detected photons per event,
+/// or "efficiency", detected over created photons (a ratio of means).
+
+class PrecisionMonitor
+{
+ public:
+  enum Observable
+  {
+    kDetected,
+    kEfficiency
+  };
+
+  static PrecisionMonitor* Instance();
+
+  // target 0 disables the monitor
+  void SetTarget(G4double relativeError, Observable observable,
+                 G4int batchSize);
+  G4bool IsActive() const { return fTarget > 0.; }
+
+  // master, at begin and end of run
+  void Reset();
+  void Print() const;
+
+  // workers, at end of event; returns true when the run should stop
+  G4bool AddEvent(G4int detected, G4int created);
+
+ private:
+  PrecisionMonitor() = default;
+
+  G4double RelativeError(const RunningStats& stats) const;
+
+  G4double fTarget = 0.;
+  Observable fObservable = kDetected;
+  G4int fBatchSize = 1000;
+
+  mutable G4Mutex fMutex;
+  RunningStats fStats;
+  std::atomic<G4int> fGeneration{ 0 };
+  std::atomic<G4bool> fStop{ false };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -33,17 +33,35 @@
 
 #include "PrimaryGeneratorAction.hh"
 
+#include "EventSeeder.hh"
+#include "PhaseSpaceFile.hh"
 #include "PrimaryGeneratorMessenger.hh"
+#include "QuasiRandom.hh"
+#include "Run.hh"
+#include "ScintillationEmitter.hh"
+#include "Shard.hh"
+#include "XraySpectrum.hh"
 
 #include "G4Event.hh"
+#include "G4Log.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
 #include "G4OpticalPhoton.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
 #include "G4SystemOfUnits.hh"
 #include "Randomize.hh"
+#include "G4Poisson.hh"
 #include <G4Gamma.hh>
 
+#include <algorithm>
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PrimaryGeneratorAction::PrimaryGeneratorAction()
@@ -83,16 +101,91 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
+  if(!fReplay.empty())
+  {
+    const SlowEvent& slow = fReplay[anEvent->GetEventID() % fReplay.size()];
+    std::istringstream status(slow.fRandomStatus);
+    G4Random::restoreFullState(status);
+    fReplayEventID = slow.fEventID;
+  }
+  else if(fEventSeeder)
+  {
+    auto runManager = G4RunManager::GetRunManager();
+    auto shard      = Shard::Instance();
+    fEventSeeder->Seed(shard->GetRunID(),
+                       shard->GetGlobalEventID(anEvent->GetEventID()));
+    // the state kept for replay (/opnovice2/timing/file) is the new one
+    G4int store = runManager->GetFlagRandomNumberStatusToG4Event();
+    if(store == 1 || store == 3)
+    {
+      std::ostringstream os;
+      G4Random::saveFullState(os);
+      G4String status = os.str();
+      anEvent->SetRandomNumberStatus(status);
+    }
+  }
+  if(fResponsePhotons > 0)
+  {
+    GenerateResponsePhotons(anEvent);
+    return;
+  }
+  if(!fDepositFile.empty())
+  {
+    GenerateDepositPhotons(anEvent);
+    return;
+  }
+  // one vertex per primary, so that tracks can be traced back to it
+  for(G4int i = 0; i < fPrimariesPerEvent; ++i)
+  {
+    if(fPhaseSpace)
+      GeneratePhaseSpacePrimary(anEvent);
+    else
+      GenerateGunPrimary(anEvent, i);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double PrimaryGeneratorAction::Uniform(std::uint64_t index, G4int dim) const
+{
+  return fQuasiRandom ? fQuasiRandom->Get(index, dim) : G4UniformRand();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::GenerateGunPrimary(G4Event* anEvent,
+                                                G4int primary)
+{
+  // the point index follows the global event number, so each worker takes
+  // its own subset of one sequence whatever the number of threads and shards
+  G4long eventID =
+    fReplay.empty()
+      ? Shard::Instance()->GetGlobalEventID(anEvent->GetEventID())
+      : fReplayEventID;
+  std::uint64_t index =
+    std::uint64_t(eventID) * fPrimariesPerEvent + primary;
+
+  G4ThreeVector position = fParticleGun->GetParticlePosition();
+  if(fBeamHalfX > 0. || fBeamHalfY > 0.)
+  {
+    G4ThreeVector offset((2. * Uniform(index, 0) - 1.) * fBeamHalfX,
+                         (2. * Uniform(index, 1) - 1.) * fBeamHalfY, 0.);
+    fParticleGun->SetParticlePosition(position + offset);
+  }
   if(fRandomDirection)
   {
-    G4double theta = CLHEP::halfpi * G4UniformRand();
-    G4double phi   = CLHEP::twopi * G4UniformRand();
+    G4double theta = CLHEP::halfpi * Uniform(index, 2);
+    G4double phi   = CLHEP::twopi * Uniform(index, 3);
     G4double x     = std::cos(theta);
     G4double y     = std::sin(theta) * std::sin(phi);
     G4double z     = std::sin(theta) * std::cos(phi);
     G4ThreeVector dir(x, y, z);
     fParticleGun->SetParticleMomentumDirection(dir);
   }
+  if(fSpectrum)
+  {
+    fParticleGun->SetParticleEnergy(fSpectrum->SampleEnergy());
+  }
   if(fParticleGun->GetParticleDefinition() ==
      G4OpticalPhoton::OpticalPhotonDefinition())
   {
@@ -102,6 +195,7 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
       SetOptPhotonPolar();
   }
   fParticleGun->GeneratePrimaryVertex(anEvent);
+  fParticleGun->SetParticlePosition(position);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -149,3 +243,200 @@ void PrimaryGeneratorAction::SetRandomDirection(G4bool val)
 {
   fRandomDirection = val;
 }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetBeamSize(G4double halfX, G4double halfY)
+{
+  fBeamHalfX = halfX;
+  fBeamHalfY = halfY;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetQuasiRandom(const G4String& kind, G4int seed)
+{
+  if(kind == "none")
+    fQuasiRandom.reset();
+  else
+    fQuasiRandom = std::make_shared<const QuasiRandom>(
+      kind == "halton" ? QuasiRandom::kHalton : QuasiRandom::kSobol,
+      std::uint32_t(seed));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::SetSpectrum(const G4String& fileName)
+{
+  if(fileName == "none")
+  {
+    fSpectrum.reset();
+    return;
+  }
+  fSpectrum = XraySpectrum::Load(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::SetFlatSpectrum(G4double emin, G4double emax)
+{
+  fSpectrum = XraySpectrum::Flat(emin, emax);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::SetPhaseSpaceFile(const G4String& fileName)
+{
+  fPhaseSpace.reset();
+  fPhaseSpaceSliceSet = false;
+  if(fileName != "none")
+    fPhaseSpace = PhaseSpaceFile::Open(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::GeneratePhaseSpacePrimary(G4Event* anEvent)
+{
+  if(!fPhaseSpaceSliceSet)
+  {
+    // disjoint slice per worker thread and shard; the sequential build
+    // reads the whole share of its shard
+    G4int nThreads = G4Threading::GetNumberOfRunningWorkerThreads();
+    G4int thread   = G4Threading::G4GetThreadId();
+    if(thread < 0 || nThreads < 1)
+    {
+      thread   = 0;
+      nThreads = 1;
+    }
+    auto shard = Shard::Instance();
+    if(shard->IsActive())
+    {
+      thread += shard->GetIndex() * nThreads;
+      nThreads *= shard->GetCount();
+    }
+    fPhaseSpace->GetSlice(thread, nThreads, fPhaseSpaceFirst,
+                          fPhaseSpaceLast);
+    fPhaseSpaceNext     = fPhaseSpaceFirst;
+    fPhaseSpaceSliceSet = true;
+  }
+  if(fPhaseSpaceNext >= fPhaseSpaceLast)
+  {
+    G4ExceptionDescription ed;
+    ed << "Phase-space slice [" << fPhaseSpaceFirst << ", " << fPhaseSpaceLast
+       << ") of " << fPhaseSpace->GetName()
+       << " is exhausted; recycling it.";
+    G4Exception("PrimaryGeneratorAction::GeneratePrimaries", "OpNovice2_012",
+                JustWarning, ed);
+    fPhaseSpaceNext = fPhaseSpaceFirst;
+  }
+
+  const auto& rec = fPhaseSpace->GetRecord(fPhaseSpaceNext++);
+
+  auto vertex = new G4PrimaryVertex(
+    G4ThreeVector(rec.fPosition[0], rec.fPosition[1], rec.fPosition[2]),
+    fParticleGun->GetParticleTime());
+  // for the record only; the tallies are unweighted (PhaseSpaceFile::Open
+  // warns about weighted files)
+  vertex->SetWeight(rec.fWeight);
+
+  auto particle =
+    new G4PrimaryParticle(fParticleGun->GetParticleDefinition());
+  particle->SetKineticEnergy(rec.fEnergy);
+  particle->SetMomentumDirection(
+    G4ThreeVector(rec.fDirection[0], rec.fDirection[1], rec.fDirection[2])
+      .unit());
+  particle->SetPolarization(rec.fPolarization[0], rec.fPolarization[1],
+                            rec.fPolarization[2]);
+  vertex->SetPrimary(particle);
+  anEvent->AddPrimaryVertex(vertex);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::GenerateResponsePhotons(G4Event* anEvent)
+{
+  auto run = static_cast<Run*>(
+    G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  ResponseMatrix& response = run->GetResponse();
+  if(!response.IsConfigured())
+    return;
+
+  // events cycle through the voxels, so every voxel gets the same share
+  G4int voxel =
+    G4int(Shard::Instance()->GetGlobalEventID(anEvent->GetEventID()) %
+          response.GetNumberOfVoxels());
+  const ScintillationEmitter& emitter = GetEmitter();
+  for(G4int i = 0; i < fResponsePhotons; ++i)
+    emitter.AddPhoton(anEvent, response.SamplePoint(voxel), 0.);
+  response.AddEmitted(voxel, fResponsePhotons);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+const ScintillationEmitter& PrimaryGeneratorAction::GetEmitter()
+{
+  if(!fEmitter)
+  {
+    // the geometry is built by now; photons follow the CsI spectrum
+    G4LogicalVolume* tank =
+      G4LogicalVolumeStore::GetInstance()->GetVolume("Tank");
+    fEmitter = std::make_unique<ScintillationEmitter>(tank->GetMaterial());
+  }
+  return *fEmitter;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::SetDepositFile(const G4String& fileName)
+{
+  fDepositReader.reset();
+  fDepositFile = fileName == "none" ? G4String() : fileName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::SetReplayFile(const G4String& fileName)
+{
+  fReplay.clear();
+  if(fileName != "none")
+    fReplay = EventTiming::Read(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::SetEventSeed(G4long seed)
+{
+  if(seed < 0)
+    fEventSeeder.reset();
+  else
+    fEventSeeder = std::make_unique<EventSeeder>(std::uint64_t(seed));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void PrimaryGeneratorAction::GenerateDepositPhotons(G4Event* anEvent)
+{
+  // opened on the first event, once the number of threads is known
+  if(!fDepositReader)
+    fDepositReader = std::make_unique<DepositReader>(fDepositFile);
+  if(!fDepositReader->NextEvent(fDeposits))
+  {
+    // no stored event left: this one is not counted, and the run ends
+    anEvent->SetEventAborted();
+    G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+
+  // photon statistics as in G4Scintillation (no rise time,
+  // RESOLUTIONSCALE 1), with the yield of the current material
+  const ScintillationEmitter& emitter = GetEmitter();
+  for(const auto& deposit : fDeposits)
+  {
+    G4double mean = emitter.GetYield() * deposit.fVisible * keV;
+    G4int n       = 0;
+    if(mean > 10.)
+      n = std::max(
+        G4int(G4RandGauss::shoot(mean, std::sqrt(mean)) + 0.5), 0);
+    else
+      n = G4int(G4Poisson(mean));
+
+    G4ThreeVector position(deposit.fPosition[0] * mm,
+                           deposit.fPosition[1] * mm,
+                           deposit.fPosition[2] * mm);
+    for(G4int i = 0; i < n; ++i)
+    {
+      G4double delay = -emitter.GetTimeConstant() * G4Log(G4UniformRand());
+      emitter.AddPhoton(anEvent, position, deposit.fTime * ns + delay);
+    }
+  }
+}
@@ -34,11 +34,22 @@
 #define PrimaryGeneratorAction_h 1
 
 #include "globals.hh"
+#include "DepositFile.hh"
+#include "EventTiming.hh"
 #include "G4ParticleGun.hh"
 #include "G4VUserPrimaryGeneratorAction.hh"
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 class G4Event;
+class EventSeeder;
+class PhaseSpaceFile;
 class PrimaryGeneratorMessenger;
+class QuasiRandom;
+class ScintillationEmitter;
+class XraySpectrum;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -58,12 +69,77 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
   G4bool GetPolarized() { return fPolarized; };
   G4double GetPolarization() { return fPolarization; }
 
+  // sample the primary energy from a tabulated tube spectrum ("none" to
+  // go back to the mono-energetic gun)
+  void SetSpectrum(const G4String& fileName);
+  // flat reference spectrum, for runs reweighted to other spectra later
+  void SetFlatSpectrum(G4double emin, G4double emax);
+  const std::shared_ptr<const XraySpectrum>& GetSpectrum() const
+  {
+    return fSpectrum;
+  }
+
+  // take primaries from a memory-mapped phase-space file ("none" to stop)
+  void SetPhaseSpaceFile(const G4String& fileName);
+
+  // several primaries per event, e.g. one TDI line-integration period
+  void SetPrimariesPerEvent(G4int n) { fPrimariesPerEvent = n; }
+  G4int GetPrimariesPerEvent() const { return fPrimariesPerEvent; }
+
+  // spread the gun position uniformly over a rectangle in x-y
+  void SetBeamSize(G4double halfX, G4double halfY);
+  // quasi-random position and direction ("sobol", "halton" or "none")
+  void SetQuasiRandom(const G4String& kind, G4int seed);
+
+  // response calibration: n scintillation photons per event from one
+  // voxel of the current run's response matrix (0 for the normal gun)
+  void SetResponsePhotons(G4int n) { fResponsePhotons = n; }
+
+  // stage 2 of the two-stage pipeline: each event replays the energy
+  // deposits of one stage-1 event as scintillation sources ("none" to stop)
+  void SetDepositFile(const G4String& fileName);
+
+  // run again the events of a /opnovice2/timing/file, event i restarting
+  // from the engine state of record i modulo their number ("none" to stop)
+  void SetReplayFile(const G4String& fileName);
+
+  // seed every event from (seed, run ID, event ID), so that results do
+  // not depend on the number of threads (negative to stop)
+  void SetEventSeed(G4long seed);
+
  private:
+  void GenerateGunPrimary(G4Event*, G4int primary);
+  G4double Uniform(std::uint64_t index, G4int dim) const;
+  void GeneratePhaseSpacePrimary(G4Event*);
+  void GenerateResponsePhotons(G4Event*);
+  void GenerateDepositPhotons(G4Event*);
+  const ScintillationEmitter& GetEmitter();
+
   G4ParticleGun* fParticleGun = nullptr;
   PrimaryGeneratorMessenger* fGunMessenger = nullptr;
   G4bool fRandomDirection = false;
   G4bool fPolarized = false;
   G4double fPolarization = 0.;
+  G4int fPrimariesPerEvent = 1;
+  G4double fBeamHalfX = 0.;
+  G4double fBeamHalfY = 0.;
+  std::shared_ptr<const QuasiRandom> fQuasiRandom;
+  std::unique_ptr<EventSeeder> fEventSeeder;
+  std::shared_ptr<const XraySpectrum> fSpectrum;
+  G4int fResponsePhotons = 0;
+  std::unique_ptr<ScintillationEmitter> fEmitter;
+  G4String fDepositFile;
+  std::unique_ptr<DepositReader> fDepositReader;
+  std::vector<EnergyDeposit> fDeposits;
+  std::vector<SlowEvent> fReplay;
+  G4int fReplayEventID = -1;  // event ID of the original run
+
+  // this thread's slice of the phase-space file
+  std::shared_ptr<const PhaseSpaceFile> fPhaseSpace;
+  G4bool fPhaseSpaceSliceSet = false;
+  std::uint64_t fPhaseSpaceFirst = 0;
+  std::uint64_t fPhaseSpaceLast = 0;
+  std::uint64_t fPhaseSpaceNext = 0;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -36,8 +36,14 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(
@@ -63,6 +69,94 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(
     "Set direction of each primary particle randomly.");
   fRandomDirectionCmd->SetDefaultValue(true);
   fRandomDirectionCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fSpectrumCmd = new G4UIcmdWithAString("/opnovice2/gun/spectrum", this);
+  fSpectrumCmd->SetGuidance("Sample the primary energy from a tube spectrum.");
+  fSpectrumCmd->SetGuidance("File columns: energy [keV], fluence.");
+  fSpectrumCmd->SetGuidance("Use 'none' for the mono-energetic gun.");
+  fSpectrumCmd->SetParameterName("fileName", false);
+  fSpectrumCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fFlatSpectrumCmd = new G4UIcommand("/opnovice2/gun/flatSpectrum", this);
+  fFlatSpectrumCmd->SetGuidance("Sample the primary energy uniformly.");
+  fFlatSpectrumCmd->SetGuidance("Used as reference spectrum for reweighting.");
+  auto eminPrm = new G4UIparameter("emin", 'd', false);
+  eminPrm->SetParameterRange("emin>=0.");
+  fFlatSpectrumCmd->SetParameter(eminPrm);
+  auto emaxPrm = new G4UIparameter("emax", 'd', false);
+  emaxPrm->SetParameterRange("emax>0.");
+  fFlatSpectrumCmd->SetParameter(emaxPrm);
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("keV");
+  fFlatSpectrumCmd->SetParameter(unitPrm);
+  fFlatSpectrumCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fPhaseSpaceCmd = new G4UIcmdWithAString("/opnovice2/gun/phaseSpace", this);
+  fPhaseSpaceCmd->SetGuidance("Read primaries from a binary phase-space file.");
+  fPhaseSpaceCmd->SetGuidance("The particle type is taken from the gun.");
+  fPhaseSpaceCmd->SetGuidance("Use 'none' to go back to the particle gun.");
+  fPhaseSpaceCmd->SetParameterName("fileName", false);
+  fPhaseSpaceCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fDepositsCmd = new G4UIcmdWithAString("/opnovice2/gun/deposits", this);
+  fDepositsCmd->SetGuidance("Replay a deposit file written by");
+  fDepositsCmd->SetGuidance(" /opnovice2/deposits/file: each event emits the");
+  fDepositsCmd->SetGuidance(" scintillation photons of one stored event.");
+  fDepositsCmd->SetGuidance("Use 'none' to go back to the particle gun.");
+  fDepositsCmd->SetParameterName("fileName", false);
+  fDepositsCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fReplayCmd = new G4UIcmdWithAString("/opnovice2/gun/replay", this);
+  fReplayCmd->SetGuidance("Run again the events of a /opnovice2/timing/file:");
+  fReplayCmd->SetGuidance(" event i restarts from the random-engine state of");
+  fReplayCmd->SetGuidance(" the i-th event of the file (modulo their number).");
+  fReplayCmd->SetGuidance("Use 'none' to go back to normal seeding.");
+  fReplayCmd->SetParameterName("fileName", false);
+  fReplayCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fEventSeedCmd = new G4UIcmdWithAnInteger("/opnovice2/gun/eventSeed", this);
+  fEventSeedCmd->SetGuidance("Seed every event from (seed, run ID, event ID)");
+  fEventSeedCmd->SetGuidance(" with a counter-based generator, so that the");
+  fEventSeedCmd->SetGuidance(" results do not depend on the number of threads");
+  fEventSeedCmd->SetGuidance(" or the event scheduling. -1 to stop.");
+  fEventSeedCmd->SetParameterName("seed", false);
+  fEventSeedCmd->SetRange("seed>=-1");
+  fEventSeedCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fPrimariesPerEventCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/gun/primariesPerEvent", this);
+  fPrimariesPerEventCmd->SetGuidance("Number of primaries in one event,");
+  fPrimariesPerEventCmd->SetGuidance(" e.g. one line-integration period.");
+  fPrimariesPerEventCmd->SetParameterName("n", false);
+  fPrimariesPerEventCmd->SetRange("n>0");
+  fPrimariesPerEventCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fBeamSizeCmd = new G4UIcommand("/opnovice2/gun/beamSize", this);
+  fBeamSizeCmd->SetGuidance("Spread the gun position uniformly in x-y");
+  fBeamSizeCmd->SetGuidance(" over +-halfX, +-halfY around /gun/position.");
+  auto halfXPrm = new G4UIparameter("halfX", 'd', false);
+  halfXPrm->SetParameterRange("halfX>=0.");
+  fBeamSizeCmd->SetParameter(halfXPrm);
+  auto halfYPrm = new G4UIparameter("halfY", 'd', false);
+  halfYPrm->SetParameterRange("halfY>=0.");
+  fBeamSizeCmd->SetParameter(halfYPrm);
+  auto lengthPrm = new G4UIparameter("unit", 's', true);
+  lengthPrm->SetDefaultUnit("mm");
+  fBeamSizeCmd->SetParameter(lengthPrm);
+  fBeamSizeCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
+
+  fQuasiRandomCmd = new G4UIcommand("/opnovice2/gun/qmc", this);
+  fQuasiRandomCmd->SetGuidance("Sample beam position and random direction");
+  fQuasiRandomCmd->SetGuidance(" from a scrambled low-discrepancy sequence.");
+  fQuasiRandomCmd->SetGuidance("Different seeds give independent replicas.");
+  auto kindPrm = new G4UIparameter("kind", 's', false);
+  kindPrm->SetParameterCandidates("sobol halton none");
+  fQuasiRandomCmd->SetParameter(kindPrm);
+  auto seedPrm = new G4UIparameter("seed", 'i', true);
+  seedPrm->SetDefaultValue(0);
+  seedPrm->SetParameterRange("seed>=0");
+  fQuasiRandomCmd->SetParameter(seedPrm);
+  fQuasiRandomCmd->AvailableForStates(G4State_Idle, G4State_PreInit);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -72,6 +166,15 @@ PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
   delete fPolarCmd;
   delete fGunDir;
   delete fRandomDirectionCmd;
+  delete fSpectrumCmd;
+  delete fFlatSpectrumCmd;
+  delete fPhaseSpaceCmd;
+  delete fDepositsCmd;
+  delete fReplayCmd;
+  delete fEventSeedCmd;
+  delete fPrimariesPerEventCmd;
+  delete fBeamSizeCmd;
+  delete fQuasiRandomCmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -95,6 +198,57 @@ void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,
   {
     fPrimaryAction->SetRandomDirection(true);
   }
+  else if(command == fSpectrumCmd)
+  {
+    fPrimaryAction->SetSpectrum(newValue);
+  }
+  else if(command == fFlatSpectrumCmd)
+  {
+    std::istringstream is(newValue);
+    G4double emin, emax;
+    G4String unit;
+    is >> emin >> emax >> unit;
+    G4double u = G4UIcommand::ValueOf(unit);
+    fPrimaryAction->SetFlatSpectrum(emin * u, emax * u);
+  }
+  else if(command == fPhaseSpaceCmd)
+  {
+    fPrimaryAction->SetPhaseSpaceFile(newValue);
+  }
+  else if(command == fDepositsCmd)
+  {
+    fPrimaryAction->SetDepositFile(newValue);
+  }
+  else if(command == fReplayCmd)
+  {
+    fPrimaryAction->SetReplayFile(newValue);
+  }
+  else if(command == fEventSeedCmd)
+  {
+    fPrimaryAction->SetEventSeed(fEventSeedCmd->GetNewIntValue(newValue));
+  }
+  else if(command == fPrimariesPerEventCmd)
+  {
+    fPrimaryAction->SetPrimariesPerEvent(
+      fPrimariesPerEventCmd->GetNewIntValue(newValue));
+  }
+  else if(command == fBeamSizeCmd)
+  {
+    std::istringstream is(newValue);
+    G4double halfX, halfY;
+    G4String unit;
+    is >> halfX >> halfY >> unit;
+    G4double u = G4UIcommand::ValueOf(unit);
+    fPrimaryAction->SetBeamSize(halfX * u, halfY * u);
+  }
+  else if(command == fQuasiRandomCmd)
+  {
+    std::istringstream is(newValue);
+    G4String kind;
+    G4int seed = 0;
+    is >> kind >> seed;
+    fPrimaryAction->SetQuasiRandom(kind, seed);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -43,6 +43,9 @@ class PrimaryGeneratorAction;
 class G4UIdirectory;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -59,6 +62,15 @@ class PrimaryGeneratorMessenger : public G4UImessenger
   G4UIdirectory* fGunDir = nullptr;
   G4UIcmdWithADoubleAndUnit* fPolarCmd = nullptr;
   G4UIcmdWithABool* fRandomDirectionCmd = nullptr;
+  G4UIcmdWithAString* fSpectrumCmd = nullptr;
+  G4UIcommand* fFlatSpectrumCmd = nullptr;
+  G4UIcmdWithAString* fPhaseSpaceCmd = nullptr;
+  G4UIcmdWithAString* fDepositsCmd = nullptr;
+  G4UIcmdWithAString* fReplayCmd = nullptr;
+  G4UIcmdWithAnInteger* fEventSeedCmd = nullptr;
+  G4UIcmdWithAnInteger* fPrimariesPerEventCmd = nullptr;
+  G4UIcommand* fBeamSizeCmd = nullptr;
+  G4UIcommand* fQuasiRandomCmd = nullptr;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
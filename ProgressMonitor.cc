@@ -0,0 +1,180 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/ProgressMonitor.cc
+/// \brief Implementation of the ProgressMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ProgressMonitor.hh"
+
+#include "Shard.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+ProgressMonitor* ProgressMonitor::Instance()
+{
+  static ProgressMonitor instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+ProgressMonitor::~ProgressMonitor()
+{
+  Stop();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+ProgressMonitor::Slot& ProgressMonitor::GetSlot()
+{
+  static G4ThreadLocal Slot* slot = nullptr;
+  if(!slot)
+  {
+    G4int id = G4Threading::G4GetThreadId() + 1;
+    slot     = &Instance()->fSlots[std::max(id, 0) % kSlots];
+  }
+  return *slot;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ProgressMonitor::Start(G4int eventsToProcess)
+{
+  Stop();
+  for(auto& slot : fSlots)
+  {
+    slot.fEvents.store(0, std::memory_order_relaxed);
+    slot.fPhotons.store(0, std::memory_order_relaxed);
+  }
+  if(fInterval <= 0.)
+    return;
+
+  fEventsToProcess = eventsToProcess;
+  fStart = fLastTime = Clock::now();
+  fLastEvents = fLastPhotons = 0;
+  std::fill(std::begin(fLastSlotEvents), std::end(fLastSlotEvents), 0);
+  if(!fFile.empty())
+  {
+    G4String fileName = Shard::Instance()->FileName(fFile);
+    G4bool empty      = !std::ifstream(fileName).good();
+    fOut.open(fileName, std::ios::app);
+    if(empty)
+      fOut << "elapsed_s,events,events_per_s,photons_per_s,threads,"
+              "imbalance,eta_s\n";
+  }
+  fStop   = false;
+  fThread = std::thread(&ProgressMonitor::Loop, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ProgressMonitor::Stop()
+{
+  if(!fThread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fWake.notify_one();
+  fThread.join();
+  Sample(true);
+  fOut.close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ProgressMonitor::Loop()
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  auto interval = std::chrono::duration<G4double>(fInterval);
+  while(!fWake.wait_for(lock, interval, [this] { return fStop; }))
+    Sample(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ProgressMonitor::Sample(G4bool last)
+{
+  // events per thread since the last sample, or over the run at the end
+  std::uint64_t events = 0, photons = 0, maxEvents = 0;
+  G4int threads = 0;
+  for(G4int i = 0; i < kSlots; ++i)
+  {
+    std::uint64_t n = fSlots[i].fEvents.load(std::memory_order_relaxed);
+    events += n;
+    photons += fSlots[i].fPhotons.load(std::memory_order_relaxed);
+    if(n > 0)
+      ++threads;
+    maxEvents = std::max(maxEvents, last ? n : n - fLastSlotEvents[i]);
+    fLastSlotEvents[i] = n;
+  }
+
+  Clock::time_point now = Clock::now();
+  G4double elapsed = std::chrono::duration<G4double>(now - fStart).count();
+  G4double dt = std::chrono::duration<G4double>(now - fLastTime).count();
+  G4double eventRate  = dt > 0. ? (events - fLastEvents) / dt : 0.;
+  G4double photonRate = dt > 0. ? (photons - fLastPhotons) / dt : 0.;
+  if(last)
+  {
+    // whole-run averages
+    eventRate  = elapsed > 0. ? events / elapsed : 0.;
+    photonRate = elapsed > 0. ? photons / elapsed : 0.;
+  }
+  // busiest thread over the mean: 1 when the load is even
+  std::uint64_t done = last ? events : events - fLastEvents;
+  G4double imbalance =
+    threads > 0 && done > 0 ? G4double(maxEvents) * threads / done : 1.;
+  G4double left = std::max(G4double(fEventsToProcess) - events, 0.);
+  G4double eta  = eventRate > 0. ? left / eventRate : -1.;
+  fLastTime     = now;
+  fLastEvents   = events;
+  fLastPhotons  = photons;
+
+  // not a Geant4 thread: G4cout is not set up here
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(1) << "[progress] " << elapsed
+       << " s: " << events << "/" << fEventsToProcess << " events, "
+       << eventRate << " events/s, " << photonRate << " photons/s, "
+       << threads << " threads, imbalance " << std::setprecision(2)
+       << imbalance;
+  if(!last && eta >= 0.)
+    line << ", ETA " << std::setprecision(0) << eta << " s";
+  std::cout << line.str() << std::endl;
+
+  if(fOut.is_open())
+  {
+    fOut << elapsed << "," << events << "," << eventRate << "," << photonRate
+         << "," << threads << "," << imbalance << "," << (last ? 0. : eta)
+         << "\n"
+         << std::flush;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
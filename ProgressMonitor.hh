@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/ProgressMonitor.hh
+/// \brief Definition of the ProgressMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ProgressMonitor_h
+#define ProgressMonitor_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Live progress of a run: a thread started by the master at begin of run
+/// wakes up every interval and reports events/s, optical photons/s, the
+/// imbalance between threads and the time left.
+///
+/// Each thread counts into its own cache line and is the only writer of
+/// it, so the counts are plain loads and stores with relaxed ordering: no
+/// lock and no read-modify-write on the event or stepping path. The
+/// monitor only reads them; a sample may be one event behind.
+
+class ProgressMonitor
+{
+ public:
+  static ProgressMonitor* Instance();
+
+  // interval 0 disables the monitor
+  void SetInterval(G4double interval) { fInterval = interval; }
+  // also append each sample to this file, as CSV
+  void SetFile(const G4String& fileName) { fFile = fileName; }
+
+  // master, at begin and end of run
+  void Start(G4int eventsToProcess);
+  void Stop();
+
+  // any thread
+  static void AddEvent() { Increment(GetSlot().fEvents); }
+  static void AddPhoton() { Increment(GetSlot().fPhotons); }
+
+ private:
+  ProgressMonitor() = default;
+  ~ProgressMonitor();
+
+  struct alignas(64) Slot
+  {
+    std::atomic<std::uint64_t> fEvents{ 0 };
+    std::atomic<std::uint64_t> fPhotons{ 0 };
+  };
+  // slot 0 for the master or a sequential run, 1 + ID for workers
+  static constexpr G4int kSlots = 256;
+
+  static Slot& GetSlot();
+  static void Increment(std::atomic<std::uint64_t>& counter)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+  void Loop();
+  void Sample(G4bool last);
+
+  G4double fInterval = 0.;  // s
+  G4String fFile;
+
+  Slot fSlots[kSlots];
+  std::thread fThread;
+  std::mutex fMutex;
+  std::condition_variable fWake;
+  G4bool fStop = false;
+
+  using Clock = std::chrono::steady_clock;
+  G4int fEventsToProcess = 0;
+  Clock::time_point fStart;
+  Clock::time_point fLastTime;
+  std::uint64_t fLastEvents = 0;
+  std::uint64_t fLastPhotons = 0;
+  std::uint64_t fLastSlotEvents[kSlots] = {};
+  std::ofstream fOut;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,176 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/QuasiRandom.cc
+/// \brief Implementation of the QuasiRandom class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "QuasiRandom.hh"
+
+#include <numeric>
+#include <utility>
+
+namespace
+{
+// Sobol direction numbers (Joe & Kuo), 32 bits per dimension
+struct SobolTable
+{
+  std::uint32_t v[QuasiRandom::kMaxDimensions][32];
+
+  SobolTable()
+  {
+    // dimension 0 is the van der Corput sequence
+    for(G4int k = 0; k < 32; ++k)
+      v[0][k] = 1u << (31 - k);
+
+    // primitive polynomial degree s, coefficients a, initial m_k
+    const G4int s[]          = { 1, 2, 3 };
+    const std::uint32_t a[]  = { 0, 1, 1 };
+    const std::uint32_t m[][3] = { { 1, 0, 0 }, { 1, 3, 0 }, { 1, 3, 1 } };
+
+    for(G4int d = 1; d < QuasiRandom::kMaxDimensions; ++d)
+    {
+      G4int deg = s[d - 1];
+      for(G4int k = 0; k < deg; ++k)
+        v[d][k] = m[d - 1][k] << (31 - k);
+      for(G4int k = deg; k < 32; ++k)
+      {
+        std::uint32_t val = v[d][k - deg] ^ (v[d][k - deg] >> deg);
+        for(G4int j = 1; j < deg; ++j)
+          if((a[d - 1] >> (deg - 1 - j)) & 1u)
+            val ^= v[d][k - j];
+        v[d][k] = val;
+      }
+    }
+  }
+};
+
+const SobolTable sobolTable;
+
+const G4int haltonBases[QuasiRandom::kMaxDimensions] = { 2, 3, 5, 7 };
+
+std::uint32_t ReverseBits(std::uint32_t x)
+{
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+  x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+// Owen scramble of a 32-bit fraction (Laine-Karras hash on reversed bits)
+std::uint32_t OwenScramble(std::uint32_t x, std::uint32_t seed)
+{
+  x = ReverseBits(x);
+  x += seed;
+  x ^= x * 0x6c50b47cu;
+  x ^= x * 0xb82f1e52u;
+  x ^= x * 0xc7afe638u;
+  x ^= x * 0x8d22f6e6u;
+  return ReverseBits(x);
+}
+
+std::uint32_t Hash(std::uint32_t x)
+{
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+QuasiRandom::QuasiRandom(Kind kind, std::uint32_t seed)
+  : fKind(kind)
+  , fSeed(seed)
+{
+  if(fKind != kHalton)
+    return;
+
+  // enough digits to resolve 2^32 points in every base
+  fPermutations.resize(kMaxDimensions);
+  for(G4int d = 0; d < kMaxDimensions; ++d)
+  {
+    G4int base    = haltonBases[d];
+    G4double span = 1.;
+    for(G4int k = 0; span < 4294967296.; ++k, span *= base)
+    {
+      std::vector<G4int> perm(base);
+      std::iota(perm.begin(), perm.end(), 0);
+      std::uint32_t h = Hash(fSeed ^ Hash(d * 64 + k + 1));
+      for(G4int i = base - 1; i > 0; --i)
+      {
+        h = Hash(h);
+        std::swap(perm[i], perm[h % (i + 1)]);
+      }
+      fPermutations[d].push_back(perm);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double QuasiRandom::Get(std::uint64_t index, G4int dim) const
+{
+  if(fKind == kSobol)
+    return Sobol(std::uint32_t(index), dim);
+  return Halton(index, dim);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double QuasiRandom::Sobol(std::uint32_t index, G4int dim) const
+{
+  std::uint32_t x = 0;
+  for(G4int k = 0; index; index >>= 1, ++k)
+    if(index & 1u)
+      x ^= sobolTable.v[dim][k];
+  x = OwenScramble(x, Hash(fSeed + 0x9e3779b9u * (dim + 1)));
+  return x * (1. / 4294967296.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double QuasiRandom::Halton(std::uint64_t index, G4int dim) const
+{
+  // scrambled radical inverse; all digit positions are permuted, including
+  // the leading zeros, so the fraction is summed over the full depth
+  G4int base        = haltonBases[dim];
+  const auto& perms = fPermutations[dim];
+  G4double inv      = 1. / base;
+  G4double scale    = inv;
+  G4double value    = 0.;
+  for(const auto& perm : perms)
+  {
+    value += perm[index % base] * scale;
+    index /= base;
+    scale *= inv;
+  }
+  return value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
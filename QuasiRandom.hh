@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/QuasiRandom.hh
+/// \brief Definition of the QuasiRandom class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef QuasiRandom_h
+#define QuasiRandom_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Scrambled low-discrepancy sequences for randomized quasi-Monte Carlo.
+///
+/// Point i of the sequence depends only on i and the seed, so workers can
+/// draw any subset (e.g. by event number) and the union over all threads is
+/// the same sequence whatever the thread count. Sobol points get a nested
+/// uniform (Owen) scramble, Halton points a random permutation of the digits
+/// of every base. Different seeds give independent replicas, whose spread
+/// estimates the error of the mean.
+
+class QuasiRandom
+{
+ public:
+  enum Kind
+  {
+    kSobol,
+    kHalton
+  };
+
+  QuasiRandom(Kind kind, std::uint32_t seed);
+  ~QuasiRandom() = default;
+
+  static constexpr G4int kMaxDimensions = 4;
+
+  // coordinate dim of point index, in [0,1)
+  G4double Get(std::uint64_t index, G4int dim) const;
+
+  Kind GetKind() const { return fKind; }
+  std::uint32_t GetSeed() const { return fSeed; }
+
+ private:
+  G4double Sobol(std::uint32_t index, G4int dim) const;
+  G4double Halton(std::uint64_t index, G4int dim) const;
+
+  Kind fKind;
+  std::uint32_t fSeed;
+  // digit permutations of every Halton dimension, one per digit position
+  std::vector<std::vector<std::vector<G4int>>> fPermutations;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,300 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/ResponseMatrix.cc
+/// \brief Implementation of the ResponseMatrix class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ResponseMatrix.hh"
+
+#include "RunState.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+namespace
+{
+G4Mutex responseMutex = G4MUTEX_INITIALIZER;
+
+const char kResponseMagic[8] = { 'O', 'P', 'N', '2', 'R', 'E', 'S', 'P' };
+const std::uint32_t kResponseVersion = 1;
+
+struct ResponseHeader
+{
+  char fMagic[8];
+  std::uint32_t fVersion;
+  std::uint32_t fN[4];  // nx, ny, nz, nt
+  std::uint32_t fReserved;
+  G4double fHalf[3];  // mm
+  G4double fTmax;  // ns
+};
+static_assert(sizeof(ResponseHeader) == 64, "unexpected response header");
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::shared_ptr<const ResponseMatrix> ResponseMatrix::Load(
+  const G4String& fileName)
+{
+  static std::map<G4String, std::shared_ptr<const ResponseMatrix>> cache;
+
+  G4AutoLock lock(&responseMutex);
+  auto it = cache.find(fileName);
+  if(it != cache.end())
+    return it->second;
+
+  std::ifstream in(fileName, std::ios::binary);
+  ResponseHeader header;
+  std::memset(&header, 0, sizeof(header));
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  G4ExceptionDescription ed;
+  if(!in || std::memcmp(header.fMagic, kResponseMagic, 8) != 0)
+    ed << fileName << " is not a response file.";
+  else if(header.fVersion != kResponseVersion)
+    ed << fileName << " has version " << header.fVersion << ", expected "
+       << kResponseVersion << ".";
+  if(!ed.str().empty())
+  {
+    G4Exception("ResponseMatrix::Load", "OpNovice2_015", FatalException, ed);
+    return nullptr;
+  }
+
+  auto response = std::make_shared<ResponseMatrix>();
+  response->Configure(header.fN[0], header.fN[1], header.fN[2],
+                      header.fHalf[0] * mm, header.fHalf[1] * mm,
+                      header.fHalf[2] * mm, header.fN[3], header.fTmax * ns);
+  auto read = [&in](std::vector<G4double>& v) {
+    in.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(G4double));
+  };
+  read(response->fEmitted);
+  read(response->fDetected);
+  read(response->fTime);
+  if(!in)
+  {
+    ed << fileName << " is truncated.";
+    G4Exception("ResponseMatrix::Load", "OpNovice2_015", FatalException, ed);
+    return nullptr;
+  }
+  cache[fileName] = response;
+
+  G4cout << "Response file " << fileName << ": " << header.fN[0] << " x "
+         << header.fN[1] << " x " << header.fN[2] << " voxels, "
+         << header.fN[3] << " time bins" << G4endl;
+  return response;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ResponseMatrix::Configure(G4int nx, G4int ny, G4int nz, G4double halfX,
+                               G4double halfY, G4double halfZ, G4int nt,
+                               G4double tMax)
+{
+  fNx      = nx;
+  fNy      = ny;
+  fNz      = nz;
+  fNt      = nt;
+  fHalf[0] = halfX;
+  fHalf[1] = halfY;
+  fHalf[2] = halfZ;
+  fTmax    = tMax;
+
+  std::size_t nVoxels = std::size_t(nx) * ny * nz;
+  fEmitted.assign(nVoxels, 0.);
+  fDetected.assign(nVoxels, 0.);
+  fTime.assign(nVoxels * nt, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4int ResponseMatrix::Voxel(const G4ThreeVector& position) const
+{
+  G4int n[3] = { fNx, fNy, fNz };
+  G4int index[3];
+  for(G4int k = 0; k < 3; ++k)
+  {
+    G4double u = (position[k] + fHalf[k]) / (2. * fHalf[k]);
+    if(u < 0. || u > 1.)
+      return -1;
+    // points on the upper face belong to the last cell
+    index[k] = std::min(G4int(u * n[k]), n[k] - 1);
+  }
+  return (index[2] * fNy + index[1]) * fNx + index[0];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4ThreeVector ResponseMatrix::SamplePoint(G4int voxel) const
+{
+  G4int index[3] = { voxel % fNx, (voxel / fNx) % fNy, voxel / (fNx * fNy) };
+  G4int n[3]     = { fNx, fNy, fNz };
+  G4ThreeVector position;
+  for(G4int k = 0; k < 3; ++k)
+  {
+    G4double width = 2. * fHalf[k] / n[k];
+    position[k]    = -fHalf[k] + (index[k] + G4UniformRand()) * width;
+  }
+  return position;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ResponseMatrix::AddDetected(G4int voxel, G4double time)
+{
+  fDetected[voxel] += 1.;
+  G4int bin = std::min(G4int(time / fTmax * fNt), fNt - 1);
+  fTime[std::size_t(voxel) * fNt + std::max(bin, 0)] += 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ResponseMatrix::Add(const ResponseMatrix& other)
+{
+  if(!other.IsConfigured())
+    return;
+  if(!IsConfigured())
+  {
+    *this = other;
+    return;
+  }
+  for(std::size_t i = 0; i < fEmitted.size(); ++i)
+  {
+    fEmitted[i] += other.fEmitted[i];
+    fDetected[i] += other.fDetected[i];
+  }
+  for(std::size_t i = 0; i < fTime.size(); ++i)
+    fTime[i] += other.fTime[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double ResponseMatrix::SampleTime(G4int voxel) const
+{
+  const G4double* time = &fTime[std::size_t(voxel) * fNt];
+  G4double r = G4UniformRand() * fDetected[voxel];
+  G4int bin  = 0;
+  for(; bin < fNt - 1 && r >= time[bin]; ++bin)
+    r -= time[bin];
+  return (bin + G4UniformRand()) * fTmax / fNt;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ResponseMatrix::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  ResponseHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.fMagic, kResponseMagic, 8);
+  header.fVersion = kResponseVersion;
+  header.fN[0]    = fNx;
+  header.fN[1]    = fNy;
+  header.fN[2]    = fNz;
+  header.fN[3]    = fNt;
+  for(G4int k = 0; k < 3; ++k)
+    header.fHalf[k] = fHalf[k] / mm;
+  header.fTmax = fTmax / ns;
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  auto write = [&out](const std::vector<G4double>& v) {
+    out.write(reinterpret_cast<const char*>(v.data()),
+              v.size() * sizeof(G4double));
+  };
+  write(fEmitted);
+  write(fDetected);
+  write(fTime);
+  if(!out)
+  {
+    G4ExceptionDescription ed;
+    ed << "Error while writing " << fileName;
+    G4Exception("ResponseMatrix::Write", "OpNovice2_013", JustWarning, ed);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ResponseMatrix::Save(StateWriter& out) const
+{
+  out.Put(fNx);
+  out.Put(fNy);
+  out.Put(fNz);
+  out.Put(fNt);
+  out.Put(fHalf);
+  out.Put(fTmax);
+  out.Put(fEmitted);
+  out.Put(fDetected);
+  out.Put(fTime);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool ResponseMatrix::Restore(StateReader& in)
+{
+  in.Get(fNx);
+  in.Get(fNy);
+  in.Get(fNz);
+  in.Get(fNt);
+  in.Get(fHalf);
+  in.Get(fTmax);
+  in.Get(fEmitted);
+  in.Get(fDetected);
+  in.Get(fTime);
+  std::size_t nVoxels = fEmitted.size();
+  return in.Good() && fDetected.size() == nVoxels &&
+         fTime.size() == nVoxels * std::size_t(std::max(fNt, 0)) &&
+         (nVoxels == 0 ||
+          nVoxels == std::size_t(fNx) * std::size_t(fNy) * std::size_t(fNz));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ResponseMatrix::Print() const
+{
+  G4double emitted  = 0.;
+  G4double detected = 0.;
+  for(std::size_t i = 0; i < fEmitted.size(); ++i)
+  {
+    emitted += fEmitted[i];
+    detected += fDetected[i];
+  }
+  G4cout << "\n-------- Optical response (" << fNx << " x " << fNy << " x "
+         << fNz << " voxels) --------" << G4endl;
+  G4cout << "Light collection, all voxels: "
+         << (emitted > 0. ? detected / emitted : 0.) << G4endl;
+  G4cout << "Depth profile (z [mm], collection):" << G4endl;
+  for(G4int iz = 0; iz < fNz; ++iz)
+  {
+    G4double e = 0.;
+    G4double d = 0.;
+    for(G4int i = iz * fNx * fNy; i < (iz + 1) * fNx * fNy; ++i)
+    {
+      e += fEmitted[i];
+      d += fDetected[i];
+    }
+    G4double z = -fHalf[2] + (iz + 0.5) * 2. * fHalf[2] / fNz;
+    G4cout << "  " << z / mm << "  " << (e > 0. ? d / e : 0.) << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
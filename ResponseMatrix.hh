@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/ResponseMatrix.hh
+/// \brief Definition of the ResponseMatrix class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ResponseMatrix_h
+#define ResponseMatrix_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <memory>
+#include <vector>
+
+class StateReader;
+class StateWriter;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Optical response of the scintillator per emission voxel: the probability
+/// that a scintillation photon emitted there is detected, and the
+/// distribution of its transport time to the photodiode.
+///
+/// The voxels split the CsI box (centred at the origin) into nx x ny x nz
+/// cells; arrival times are binned in nt bins up to tMax, the last bin
+/// taking the overflow. A calibration run fills emitted and detected
+/// counts; the result is written to a versioned binary file:
+/// magic "OPN2RESP", uint32 version, nx, ny, nz, nt, reserved, doubles
+/// half-x, half-y, half-z [mm], tMax [ns], then doubles emitted[voxel],
+/// detected[voxel] and time[voxel][nt], voxel = (iz * ny + iy) * nx + ix.
+
+class ResponseMatrix
+{
+ public:
+  static std::shared_ptr<const ResponseMatrix> Load(const G4String& fileName);
+
+  ResponseMatrix() = default;
+  ~ResponseMatrix() = default;
+
+  void Configure(G4int nx, G4int ny, G4int nz, G4double halfX,
+                 G4double halfY, G4double halfZ, G4int nt, G4double tMax);
+  G4bool IsConfigured() const { return !fEmitted.empty(); }
+  G4int GetNumberOfVoxels() const { return G4int(fEmitted.size()); }
+
+  // -1 outside the box
+  G4int Voxel(const G4ThreeVector& position) const;
+  G4ThreeVector SamplePoint(G4int voxel) const;
+
+  void AddEmitted(G4int voxel, G4double n) { fEmitted[voxel] += n; }
+  void AddDetected(G4int voxel, G4double time);
+  void Add(const ResponseMatrix& other);
+
+  G4double Probability(G4int voxel) const
+  {
+    return fEmitted[voxel] > 0. ? fDetected[voxel] / fEmitted[voxel] : 0.;
+  }
+  // transport time of a detected photon emitted in the voxel
+  G4double SampleTime(G4int voxel) const;
+
+  void Write(const G4String& fileName) const;
+  void Print() const;
+
+  // binning and tallies, for run state files (see RunState)
+  void Save(StateWriter& out) const;
+  G4bool Restore(StateReader& in);
+
+ private:
+  G4int fNx = 0;
+  G4int fNy = 0;
+  G4int fNz = 0;
+  G4int fNt = 0;
+  G4double fHalf[3] = { 0., 0., 0. };
+  G4double fTmax = 0.;
+  std::vector<G4double> fEmitted;
+  std::vector<G4double> fDetected;
+  std::vector<G4double> fTime;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -34,11 +34,18 @@
 
 #include "DetectorConstruction.hh"
 #include "HistoManager.hh"
+#include "RunState.hh"
 
+#include "G4Event.hh"
 #include "G4OpBoundaryProcess.hh"
+#include "G4ParticleTable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
 #include <numeric>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -46,6 +53,19 @@ Run::Run()
   : G4Run()
 {
   fBoundaryProcs.assign(43, 0);
+
+  // take the binning of the booked H2s (mm), possibly set by /analysis/h2/set
+  auto analysisMan = G4AnalysisManager::Instance();
+  auto configure   = [analysisMan](Histo2D& map, const G4String& name) {
+    G4int id = analysisMan->GetH2Id(name, false);
+    if(id < 0 || !analysisMan->GetH2Activation(id))
+      return;
+    map.Configure(analysisMan->GetH2Nxbins(id), analysisMan->GetH2Xmin(id),
+                  analysisMan->GetH2Xmax(id), analysisMan->GetH2Nybins(id),
+                  analysisMan->GetH2Ymin(id), analysisMan->GetH2Ymax(id));
+  };
+  configure(fPDHitMap, "PD hits");
+  configure(fEntranceMap, "Entrance");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -58,6 +78,81 @@ void Run::SetPrimary(G4ParticleDefinition* particle, G4double energy,
   fPolarization = polarization;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Run::AddFrame(G4int detected, const std::vector<G4int>& perPrimary)
+{
+  fMaxPrimaries = std::max(fMaxPrimaries, (G4int) perPrimary.size());
+  fFrameSum += detected;
+  fFrameSum2 += (G4double) detected * detected;
+  for(auto n : perPrimary)
+  {
+    fPrimaryN += 1.;
+    fPrimarySum += n;
+    fPrimarySum2 += (G4double) n * n;
+    if(n == 0)
+      fPrimaryZero += 1.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Run::AddPulseHeight(G4int detected, G4bool absorbed)
+{
+  ++fPulseEvents;
+  if(!absorbed)
+    return;
+  ++fPulseAbsorbed;
+  G4double power = 1.;
+  for(auto& moment : fPulseMoments)
+  {
+    power *= detected;
+    moment.Add(power);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Run::SetArrivalBinning(G4int n, G4double lambdaMin, G4double lambdaMax)
+{
+  fArrival.assign(n, 0.);
+  fArrivalMin     = lambdaMin;
+  fArrivalMax     = lambdaMax;
+  fArrivalScale   = n / (lambdaMax - lambdaMin);
+  fArrivalOutside = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Run::WriteArrivalSpectrum(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if(!out)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open " << fileName << " for writing.";
+    G4Exception("Run::WriteArrivalSpectrum", "OpNovice2_013", JustWarning, ed);
+    return;
+  }
+  // the photodiode should be a perfect absorber for this to be the true
+  // arrival spectrum; electrons per event = sum(QE(lambda) * per_event)
+  G4double width  = (fArrivalMax - fArrivalMin) / fArrival.size();
+  G4double events = std::max(numberOfEvent, 1);
+  out << "# events " << numberOfEvent << "\n"
+      << "# outside_range " << fArrivalOutside << "\n"
+      << "# bin_width_nm " << width / nm << "\n"
+      << "# wavelength_nm photons photons_per_event\n";
+  out << std::setprecision(6);
+  for(std::size_t i = 0; i < fArrival.size(); ++i)
+  {
+    out << (fArrivalMin + (i + 0.5) * width) / nm << " " << fArrival[i] << " "
+        << fArrival[i] / events << "\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Run::RecordEvent(const G4Event* event)
+{
+  if(!event->IsAborted())
+    G4Run::RecordEvent(event);
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void Run::Merge(const G4Run* run)
 {
@@ -68,6 +163,40 @@ void Run::Merge(const G4Run* run)
   fEkin         = localRun->fEkin;
   fPolarized    = localRun->fPolarized;
   fPolarization = localRun->fPolarization;
+  fSpectrum     = localRun->fSpectrum;
+
+  fEventRecords.insert(fEventRecords.end(), localRun->fEventRecords.begin(),
+                       localRun->fEventRecords.end());
+
+  fMaxPrimaries = std::max(fMaxPrimaries, localRun->fMaxPrimaries);
+  fFrameSum += localRun->fFrameSum;
+  fFrameSum2 += localRun->fFrameSum2;
+  fPrimaryN += localRun->fPrimaryN;
+  fPrimarySum += localRun->fPrimarySum;
+  fPrimarySum2 += localRun->fPrimarySum2;
+  fPrimaryZero += localRun->fPrimaryZero;
+
+  fPDHitMap.Add(localRun->fPDHitMap);
+  fEntranceMap.Add(localRun->fEntranceMap);
+  fSpreadMap.Add(localRun->fSpreadMap);
+  if(fArrival.size() == localRun->fArrival.size())
+  {
+    for(std::size_t i = 0; i < fArrival.size(); ++i)
+      fArrival[i] += localRun->fArrival[i];
+  }
+  fArrivalOutside += localRun->fArrivalOutside;
+
+  fOpticalReweighter.Add(localRun->fOpticalReweighter);
+  fResponse.Add(localRun->fResponse);
+  fResponseModel = localRun->fResponseModel;
+  fFoldedExpected += localRun->fFoldedExpected;
+  fFoldedDetected += localRun->fFoldedDetected;
+  fFoldedTime += localRun->fFoldedTime;
+
+  fPulseEvents += localRun->fPulseEvents;
+  fPulseAbsorbed += localRun->fPulseAbsorbed;
+  for(G4int k = 0; k < 4; ++k)
+    fPulseMoments[k].Add(localRun->fPulseMoments[k]);
 
   fCerenkovEnergy += localRun->fCerenkovEnergy;
   fScintEnergy += localRun->fScintEnergy;
@@ -76,6 +205,13 @@ void Run::Merge(const G4Run* run)
   fWLS2AbsorptionEnergy += localRun->fWLS2AbsorptionEnergy;
   fWLS2EmissionEnergy += localRun->fWLS2EmissionEnergy;
 
+  if(fStepProfile && localRun->fStepProfile)
+    fStepProfile->Add(*localRun->fStepProfile);
+  if(fEventTiming && localRun->fEventTiming)
+    fEventTiming->Add(*localRun->fEventTiming);
+  fOpticalSteps += localRun->fOpticalSteps;
+  fOpticalTracks += localRun->fOpticalTracks;
+  fEventDigest += localRun->fEventDigest;
   fCerenkovCount += localRun->fCerenkovCount;
   fScintCount += localRun->fScintCount;
   fWLSAbsorptionCount += localRun->fWLSAbsorptionCount;
@@ -94,10 +230,157 @@ void Run::Merge(const G4Run* run)
     fBoundaryProcs[i] += localRun->fBoundaryProcs[i];
   }
   fExitPlusZ += localRun->fExitPlusZ;
+  fHitPD += localRun->fHitPD;
+  fDetectedPD += localRun->fDetectedPD;
 
   G4Run::Merge(run);
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Run::Save(StateWriter& out) const
+{
+  out.Put(numberOfEvent);
+  out.Put(fParticle ? fParticle->GetParticleName() : G4String());
+  out.Put(fEkin);
+  out.Put(fPolarized);
+  out.Put(fPolarization);
+  out.Put(fRecordEvents);
+  out.Put(fEventRecords);
+
+  out.Put(fMaxPrimaries);
+  out.Put(fFrameSum);
+  out.Put(fFrameSum2);
+  out.Put(fPrimaryN);
+  out.Put(fPrimarySum);
+  out.Put(fPrimarySum2);
+  out.Put(fPrimaryZero);
+  out.Put(fPulseEvents);
+  out.Put(fPulseAbsorbed);
+  out.Put(fPulseMoments);
+
+  fPDHitMap.Save(out);
+  fEntranceMap.Save(out);
+  fSpreadMap.Save(out);
+  out.Put(fArrival);
+  out.Put(fArrivalMin);
+  out.Put(fArrivalMax);
+  out.Put(fArrivalScale);
+  out.Put(fArrivalOutside);
+
+  fOpticalReweighter.Save(out);
+  fResponse.Save(out);
+  out.Put(fFoldedExpected);
+  out.Put(fFoldedDetected);
+  out.Put(fFoldedTime);
+
+  out.Put(fCerenkovEnergy);
+  out.Put(fScintEnergy);
+  out.Put(fWLSAbsorptionEnergy);
+  out.Put(fWLSEmissionEnergy);
+  out.Put(fWLS2AbsorptionEnergy);
+  out.Put(fWLS2EmissionEnergy);
+
+  out.Put(fOpticalSteps);
+  out.Put(fOpticalTracks);
+  out.Put(fEventDigest);
+  out.Put(fCerenkovCount);
+  out.Put(fScintCount);
+  out.Put(fWLSAbsorptionCount);
+  out.Put(fWLSEmissionCount);
+  out.Put(fWLS2AbsorptionCount);
+  out.Put(fWLS2EmissionCount);
+  out.Put(fRayleighCount);
+  out.Put(fOpAbsorption);
+  out.Put(fOpAbsorptionPrior);
+  out.Put(fBoundaryProcs);
+  out.Put(fTotalSurface);
+  out.Put(fExitPlusZ);
+  out.Put(fHitPD);
+  out.Put(fDetectedPD);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool Run::Restore(StateReader& in)
+{
+  G4String particle;
+  in.Get(numberOfEvent);
+  in.Get(particle);
+  in.Get(fEkin);
+  in.Get(fPolarized);
+  in.Get(fPolarization);
+  in.Get(fRecordEvents);
+  in.Get(fEventRecords);
+  fParticle = particle.empty()
+                ? nullptr
+                : G4ParticleTable::GetParticleTable()->FindParticle(particle);
+
+  in.Get(fMaxPrimaries);
+  in.Get(fFrameSum);
+  in.Get(fFrameSum2);
+  in.Get(fPrimaryN);
+  in.Get(fPrimarySum);
+  in.Get(fPrimarySum2);
+  in.Get(fPrimaryZero);
+  in.Get(fPulseEvents);
+  in.Get(fPulseAbsorbed);
+  in.Get(fPulseMoments);
+
+  if(!fPDHitMap.Restore(in) || !fEntranceMap.Restore(in) ||
+     !fSpreadMap.Restore(in))
+    return false;
+  in.Get(fArrival);
+  in.Get(fArrivalMin);
+  in.Get(fArrivalMax);
+  in.Get(fArrivalScale);
+  in.Get(fArrivalOutside);
+
+  if(!fOpticalReweighter.Restore(in) || !fResponse.Restore(in))
+    return false;
+  in.Get(fFoldedExpected);
+  in.Get(fFoldedDetected);
+  in.Get(fFoldedTime);
+
+  in.Get(fCerenkovEnergy);
+  in.Get(fScintEnergy);
+  in.Get(fWLSAbsorptionEnergy);
+  in.Get(fWLSEmissionEnergy);
+  in.Get(fWLS2AbsorptionEnergy);
+  in.Get(fWLS2EmissionEnergy);
+
+  in.Get(fOpticalSteps);
+  in.Get(fOpticalTracks);
+  in.Get(fEventDigest);
+  in.Get(fCerenkovCount);
+  in.Get(fScintCount);
+  in.Get(fWLSAbsorptionCount);
+  in.Get(fWLSEmissionCount);
+  in.Get(fWLS2AbsorptionCount);
+  in.Get(fWLS2EmissionCount);
+  in.Get(fRayleighCount);
+  in.Get(fOpAbsorption);
+  in.Get(fOpAbsorptionPrior);
+  in.Get(fBoundaryProcs);
+  in.Get(fTotalSurface);
+  in.Get(fExitPlusZ);
+  in.Get(fHitPD);
+  in.Get(fDetectedPD);
+  return in.Good() && fBoundaryProcs.size() == 43 &&
+         (!fParticle == particle.empty());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Run::PrintScintillationSummary() const
+{
+  // flat estimate; /opnovice2/reweight/qeFile folds a measured curve
+  const G4double QE = 0.9;
+  G4cout << "\n=== CsI SCINTILLATION SUMMARY ===\n"
+         << "Total scintillation photons created: " << fScintCount << "\n"
+         << "Photons exiting CsI +Z face:        " << fExitPlusZ << "\n"
+         << "Photons detected at PD (global):      " << fDetectedPD << "\n"
+         << "Estimated electrons: " << QE * fDetectedPD << G4endl;
+  G4cout << "====================================\n" << G4endl;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 //void Run::EndOfRun()
 void Run::EndOfRun() const
@@ -751,4 +1034,113 @@ void Run::EndOfRun() const
   }
   G4cout << "Photons exiting CsI +Z face:     " << fExitPlusZ << G4endl;
 
+  // hand the merged dense maps to the analysis manager, one fill per bin
+  auto copyMap = [analysisMan](const Histo2D& map, const G4String& name) {
+    if(!map.IsConfigured())
+      return;
+    G4int id = analysisMan->GetH2Id(name);
+    for(G4int j = 0; j < map.GetNy(); ++j)
+      for(G4int i = 0; i < map.GetNx(); ++i)
+        if(map.GetBinContent(i, j) != 0.)
+          analysisMan->FillH2(id, map.GetBinCenterX(i), map.GetBinCenterY(j),
+                              map.GetBinContent(i, j));
+    G4cout << name << " map: " << map.GetSum() << " entries, "
+           << map.GetOutside() << " outside the histogram range" << G4endl;
+  };
+  copyMap(fPDHitMap, "PD hits");
+  copyMap(fEntranceMap, "Entrance");
+
+  // Swank factor I = M1^2 / (M0 M2) of the pulse-height distribution of
+  // absorbed events, absorption fraction A and DQE(0) = A I. Errors from
+  // the delta method with the third and fourth moments; 95% intervals.
+  if(fPulseAbsorbed > 1)
+  {
+    G4double n  = (G4double) fPulseAbsorbed;
+    G4double m1 = fPulseMoments[0].Value() / n;
+    G4double m2 = fPulseMoments[1].Value() / n;
+    G4double m3 = fPulseMoments[2].Value() / n;
+    G4double m4 = fPulseMoments[3].Value() / n;
+
+    G4double swank = 0.;
+    G4double varI  = 0.;
+    if(m2 > 0.)
+    {
+      swank = m1 * m1 / m2;
+      // covariance of the sample moments m1, m2
+      G4double var1  = (m2 - m1 * m1) / n;
+      G4double var2  = (m4 - m2 * m2) / n;
+      G4double cov12 = (m3 - m1 * m2) / n;
+      G4double dI1   = 2. * m1 / m2;
+      G4double dI2   = -m1 * m1 / (m2 * m2);
+      varI = dI1 * dI1 * var1 + dI2 * dI2 * var2 + 2. * dI1 * dI2 * cov12;
+      varI = std::max(varI, 0.);
+    }
+
+    // Wilson score interval for the absorption fraction
+    G4double z          = 1.96;
+    G4double total      = (G4double) fPulseEvents;
+    G4double absorption = n / total;
+    G4double varA       = absorption * (1. - absorption) / total;
+    G4double center =
+      (absorption + z * z / (2. * total)) / (1. + z * z / total);
+    G4double halfWidth = z / (1. + z * z / total) *
+                         std::sqrt(varA + z * z / (4. * total * total));
+
+    G4double dqe    = absorption * swank;
+    G4double dqeErr = 0.;
+    if(swank > 0.)
+      dqeErr = dqe * std::sqrt(varA / (absorption * absorption) +
+                               varI / (swank * swank));
+
+    G4cout << "\n-------- Detective quantum efficiency ("
+           << fPulseAbsorbed << " of " << fPulseEvents
+           << " events absorbed) --------" << G4endl;
+    G4cout << "Absorption fraction: " << absorption << "  95% CI ["
+           << center - halfWidth << ", " << center + halfWidth << "]"
+           << G4endl;
+    G4cout << "Swank factor: " << swank << " +- " << z * std::sqrt(varI)
+           << " (95%)" << G4endl;
+    G4cout << "DQE(0): " << dqe << " +- " << z * dqeErr << " (95%)"
+           << G4endl;
+  }
+
+  fOpticalReweighter.Print();
+
+  // X-ray-only run folded with a response file (no model once merged
+  // from state files)
+  if(fResponseModel || fFoldedExpected > 0.)
+  {
+    G4cout << "\n-------- Response folding --------" << G4endl;
+    G4cout << "Expected detected photons per event: "
+           << fFoldedExpected / TotNbofEvents << G4endl;
+    G4cout << "Sampled detected photons per event:  "
+           << fFoldedDetected / TotNbofEvents << G4endl;
+    if(fFoldedDetected > 0.)
+      G4cout << "Mean arrival time: "
+             << G4BestUnit(fFoldedTime / fFoldedDetected, "Time") << G4endl;
+  }
+
+  // frame observables, only meaningful with several primaries per event
+  if(fMaxPrimaries > 1 && fPrimaryN > 1.)
+  {
+    G4double frameMean = fFrameSum / TotNbofEvents;
+    G4double frameVar  = fFrameSum2 / TotNbofEvents - frameMean * frameMean;
+    G4double primMean  = fPrimarySum / fPrimaryN;
+    G4double primVar   = fPrimarySum2 / fPrimaryN - primMean * primMean;
+    G4double perFrame  = fPrimaryN / TotNbofEvents;
+
+    G4cout << "\n-------- Frame integration (" << perFrame
+           << " primaries per event) --------" << G4endl;
+    G4cout << "Detected per frame:    mean " << frameMean << "  rms "
+           << std::sqrt(std::max(frameVar, 0.)) << G4endl;
+    G4cout << "Detected per primary:  mean " << primMean << "  rms "
+           << std::sqrt(std::max(primVar, 0.)) << G4endl;
+    G4cout << "Primaries with no detected photon: "
+           << fPrimaryZero / fPrimaryN * 100. << " %" << G4endl;
+    // pile-up check: independent primaries give var(frame) = K var(primary)
+    if(primVar > 0.)
+      G4cout << "Frame variance / (K x primary variance): "
+             << frameVar / (perFrame * primVar) << G4endl;
+  }
+
 }
@@ -1,10 +1,25 @@
 #ifndef Run_h
 #define Run_h 1
 
+#include "CompensatedSum.hh"
+#include "EventAction.hh"
+#include "EventTiming.hh"
+#include "Histo2D.hh"
+#include "OpticalReweighter.hh"
+#include "ResponseMatrix.hh"
+#include "StepProfile.hh"
+
 #include "G4OpBoundaryProcess.hh"
 #include "G4Run.hh"
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 class G4ParticleDefinition;
+class StateReader;
+class StateWriter;
+class XraySpectrum;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 class Run : public G4Run
@@ -15,6 +30,106 @@ class Run : public G4Run
 
   void SetPrimary(G4ParticleDefinition* particle, G4double energy,
                   G4bool polarized, G4double polarization);
+  // spectrum the primary energies were drawn from, if any
+  void SetSpectrum(const std::shared_ptr<const XraySpectrum>& spectrum)
+  {
+    fSpectrum = spectrum;
+  }
+  const std::shared_ptr<const XraySpectrum>& GetSpectrum() const
+  {
+    return fSpectrum;
+  }
+
+  // per-event records, kept only when requested (spectral reweighting)
+  void SetRecordEvents(G4bool val) { fRecordEvents = val; }
+  G4bool GetRecordEvents() const { return fRecordEvents; }
+  void AddEventRecord(const EventRecord& rec) { fEventRecords.push_back(rec); }
+  const std::vector<EventRecord>& GetEventRecords() const
+  {
+    return fEventRecords;
+  }
+
+  // detected photons of one event (frame) and of each of its primaries
+  void AddFrame(G4int detected, const std::vector<G4int>& perPrimary);
+
+  // pulse-height moments of detected photons per event, for the Swank
+  // factor and DQE(0); absorbed means energy was deposited in the CsI
+  void AddPulseHeight(G4int detected, G4bool absorbed);
+
+  // 2D maps; filled only when the matching H2 is activated
+  void FillPDHit(G4double x, G4double y)
+  {
+    if(fPDHitMap.IsConfigured())
+      fPDHitMap.Fill(x, y);
+  }
+  void FillEntrance(G4double x, G4double y)
+  {
+    if(fEntranceMap.IsConfigured())
+      fEntranceMap.Fill(x, y);
+  }
+  // detected position relative to the primary's entrance point (PSF)
+  void SetSpreadBinning(G4int n, G4double halfWidth)
+  {
+    fSpreadMap.Configure(n, -halfWidth, halfWidth, n, -halfWidth, halfWidth);
+  }
+  void FillSpread(G4double dx, G4double dy)
+  {
+    if(fSpreadMap.IsConfigured())
+      fSpreadMap.Fill(dx, dy);
+  }
+  const Histo2D& GetSpreadMap() const { return fSpreadMap; }
+
+  // wavelength spectrum of photons reaching the photodiode, so that QE
+  // curves can be folded in after the run
+  void SetArrivalBinning(G4int n, G4double lambdaMin, G4double lambdaMax);
+  void FillArrival(G4double wavelength)
+  {
+    if(fArrival.empty())
+      return;
+    G4double u = (wavelength - fArrivalMin) * fArrivalScale;
+    if(u < 0. || u >= fArrival.size())
+      fArrivalOutside += 1.;
+    else
+      fArrival[std::size_t(u)] += 1.;
+  }
+  void WriteArrivalSpectrum(const G4String& fileName) const;
+  const Histo2D& GetPDHitMap() const { return fPDHitMap; }
+  const Histo2D& GetEntranceMap() const { return fEntranceMap; }
+
+  // detected photons reweighted to other optical parameters
+  OpticalReweighter& GetOpticalReweighter() { return fOpticalReweighter; }
+  const OpticalReweighter& GetOpticalReweighter() const
+  {
+    return fOpticalReweighter;
+  }
+
+  // optical response per emission voxel, filled by a calibration run
+  ResponseMatrix& GetResponse() { return fResponse; }
+  const ResponseMatrix& GetResponse() const { return fResponse; }
+  void AddResponseDetected(const G4ThreeVector& vertex, G4double time)
+  {
+    if(fResponse.IsConfigured())
+    {
+      G4int voxel = fResponse.Voxel(vertex);
+      if(voxel >= 0)
+        fResponse.AddDetected(voxel, time);
+    }
+  }
+  // response file folded with the scintillation photons of this run
+  void SetResponseModel(const std::shared_ptr<const ResponseMatrix>& model)
+  {
+    fResponseModel = model;
+  }
+  const ResponseMatrix* GetResponseModel() const
+  {
+    return fResponseModel.get();
+  }
+  void AddFolded(G4double probability) { fFoldedExpected += probability; }
+  void AddFoldedDetected(G4double arrivalTime)
+  {
+    fFoldedDetected += 1.;
+    fFoldedTime += arrivalTime;
+  }
 
   //  particle energy
   void AddCerenkovEnergy(G4double en) { fCerenkovEnergy += en; }
@@ -24,6 +139,30 @@ class Run : public G4Run
   void AddWLS2AbsorptionEnergy(G4double en) { fWLS2AbsorptionEnergy += en; }
   void AddWLS2EmissionEnergy(G4double en) { fWLS2EmissionEnergy += en; }
 
+  // steps and time per particle, process and volume; null when disabled
+  void EnableStepProfile() { fStepProfile = std::make_unique<StepProfile>(); }
+  StepProfile* GetStepProfile() const { return fStepProfile.get(); }
+  // wall time per event and the slowest events; null when disabled
+  void EnableEventTiming(G4int slowest)
+  {
+    fEventTiming = std::make_unique<EventTiming>(slowest);
+  }
+  EventTiming* GetEventTiming() const { return fEventTiming.get(); }
+
+  // optical photon steps and tracks, for throughput reports
+  void AddOpticalStep(G4bool firstStep)
+  {
+    fOpticalSteps += 1;
+    if(firstStep)
+      fOpticalTracks += 1;
+  }
+  std::uint64_t GetOpticalSteps() const { return fOpticalSteps; }
+  std::uint64_t GetOpticalTracks() const { return fOpticalTracks; }
+
+  // sum over events of a hash of their results, see EventSeeder
+  void AddEventDigest(std::uint64_t digest) { fEventDigest += digest; }
+  std::uint64_t GetEventDigest() const { return fEventDigest; }
+
   // number of particles
   void AddCerenkov() { fCerenkovCount += 1; }
   void AddScintillation() { fScintCount += 1; }
@@ -171,13 +310,21 @@ class Run : public G4Run
     fBoundaryProcs[CoatedDielectricFrustratedTransmission] += 1;
   }
 
+  // aborted events (after the end of a replayed deposit file) not counted
+  void RecordEvent(const G4Event*) override;
   void Merge(const G4Run*) override;
+  // the quantities combined by Merge, for run state files (see RunState);
+  // Restore overwrites them. Step profile and event timing are not saved.
+  void Save(StateWriter& out) const;
+  G4bool Restore(StateReader& in);
   void AddExitPlusZ() { fExitPlusZ++; }
-  G4int GetExitPlusZ() const { return fExitPlusZ; }
+  std::uint64_t GetExitPlusZ() const { return fExitPlusZ; }
   void AddHitPD() { fHitPD++; }
   void AddDetectedPD() { fDetectedPD++; }
-  G4int GetHitPD() const { return fHitPD; }
-  G4int GetDetectedPD() const { return fDetectedPD; }
+  std::uint64_t GetHitPD() const { return fHitPD; }
+  std::uint64_t GetDetectedPD() const { return fDetectedPD; }
+  // photons created, exiting +Z and detected, and the electrons expected
+  void PrintScintillationSummary() const;
   void AddScintEnergy(G4double en) { fScintEnergy += en; }
 
   void CountBoundaryStatus(G4OpBoundaryProcessStatus status) { 
@@ -194,6 +341,40 @@ class Run : public G4Run
   G4double fEkin = -1.;
   G4bool fPolarized = false;
   G4double fPolarization = 0.;
+  std::shared_ptr<const XraySpectrum> fSpectrum;
+
+  G4bool fRecordEvents = false;
+  std::vector<EventRecord> fEventRecords;
+
+  // frame integration: moments per event and per primary
+  G4int fMaxPrimaries = 0;
+  G4double fFrameSum = 0.;
+  G4double fFrameSum2 = 0.;
+  G4double fPrimaryN = 0.;
+  G4double fPrimarySum = 0.;
+  G4double fPrimarySum2 = 0.;
+  G4double fPrimaryZero = 0.;
+
+  // events seen and absorbed, sums of n^k over absorbed events (k = 1..4)
+  std::uint64_t fPulseEvents = 0;
+  std::uint64_t fPulseAbsorbed = 0;
+  CompensatedSum fPulseMoments[4];
+
+  Histo2D fPDHitMap;
+  Histo2D fEntranceMap;
+  Histo2D fSpreadMap;
+  std::vector<G4double> fArrival;
+  G4double fArrivalMin = 0.;
+  G4double fArrivalMax = 0.;
+  G4double fArrivalScale = 0.;  // bins per unit length
+  G4double fArrivalOutside = 0.;
+
+  OpticalReweighter fOpticalReweighter;
+  ResponseMatrix fResponse;
+  std::shared_ptr<const ResponseMatrix> fResponseModel;
+  G4double fFoldedExpected = 0.;
+  G4double fFoldedDetected = 0.;
+  G4double fFoldedTime = 0.;
 
   G4double fCerenkovEnergy = 0.;
   G4double fScintEnergy = 0.;
@@ -203,8 +384,13 @@ class Run : public G4Run
   G4double fWLS2EmissionEnergy = 0.;
 
   // number of particles
+  std::unique_ptr<StepProfile> fStepProfile;
+  std::unique_ptr<EventTiming> fEventTiming;
+  std::uint64_t fOpticalSteps = 0;
+  std::uint64_t fOpticalTracks = 0;
+  std::uint64_t fEventDigest = 0;
   G4int fCerenkovCount = 0;
-  G4int fScintCount = 0;
+  std::uint64_t fScintCount = 0;
   G4int fWLSAbsorptionCount = 0;
   G4int fWLSEmissionCount = 0;
   G4int fWLS2AbsorptionCount = 0;
@@ -222,9 +408,9 @@ class Run : public G4Run
   std::vector<G4int> fBoundaryProcs;
 
   G4int fTotalSurface = 0;
-  G4int fExitPlusZ = 0;
-  G4int fHitPD = 0;
-  G4int fDetectedPD = 0;
+  std::uint64_t fExitPlusZ = 0;
+  std::uint64_t fHitPD = 0;
+  std::uint64_t fDetectedPD = 0;
 };
 
 #endif /* Run_h */
@@ -1,16 +1,34 @@
 #include "RunAction.hh"
+#include "Benchmark.hh"
+#include "Checkpoint.hh"
+#include "DetectorConstruction.hh"
 #include "HistoManager.hh"
+#include "OpticalTable.hh"
+#include "DepositFile.hh"
+#include "EventTuple.hh"
+#include "PhotonHitStream.hh"
+#include "PrecisionMonitor.hh"
+#include "ProgressMonitor.hh"
 #include "PrimaryGeneratorAction.hh"
+#include "ResponseMatrix.hh"
 #include "Run.hh"
+#include "RunMessenger.hh"
+#include "RunState.hh"
+#include "Shard.hh"
+#include "SpectralReweighter.hh"
+#include "SpreadFunction.hh"
+#include "XraySpectrum.hh"
 #include "G4Run.hh"
+#include "G4RunManager.hh"
 #include "G4UnitsTable.hh"
 #include "G4AnalysisManager.hh"
+#include "G4Exp.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4MaterialPropertiesTable.hh"
 
-extern long gTotalScint;
-extern long gEscape;
-
-// ADD THIS GLOBAL COUNTER
-long gDetectedPhotons = 0;
+#include <cmath>
+#include <iomanip>
+#include <sstream>
 
 RunAction::RunAction(PrimaryGeneratorAction* prim)
     : G4UserRunAction(),
@@ -20,40 +38,91 @@ RunAction::RunAction(PrimaryGeneratorAction* prim)
     fExitPhotonCount(0)
 {
     G4AccumulableManager::Instance()->RegisterAccumulable(fExitPhotonCount);
+    fRunMessenger = new RunMessenger(this);
 }
 
 RunAction::~RunAction()
 {
     delete fHistoManager;
+    delete fRunMessenger;
 }
 
 G4Run* RunAction::GenerateRun()
 {
     fRun = new Run();
+    fRun->SetRecordEvents(!fReweightTargets.empty() || !fEventFile.empty());
+    if (!fResolutionFile.empty())
+        fRun->SetSpreadBinning(fResolutionBins, fResolutionHalfWidth);
+    if (!fArrivalFile.empty())
+        fRun->SetArrivalBinning(fArrivalBins, fArrivalMin, fArrivalMax);
+    if (fProfile) fRun->EnableStepProfile();
+    if (fEventTiming) {
+        fRun->EnableEventTiming(fSlowestEvents);
+        // engine state before primary generation, kept in each G4Event
+        G4RunManager::GetRunManager()->StoreRandomNumberStatusToG4Event(1);
+    }
+    fRun->GetOpticalReweighter().SetTargets(MakeOpticalTargets());
+    if (!fResponseFile.empty()) {
+        auto det = static_cast<const DetectorConstruction*>(
+            G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+        fRun->GetResponse().Configure(
+            fResponseVoxels[0], fResponseVoxels[1], fResponseVoxels[2],
+            det->GetTankX(), det->GetTankY(), det->GetTankZ(),
+            fResponseTimeBins, fResponseTmax);
+    }
+    else {
+        fRun->SetResponseModel(fResponseModel);
+    }
     return fRun;
 }
 
-void RunAction::BeginOfRunAction(const G4Run*)
+void RunAction::BeginOfRunAction(const G4Run* aRun)
 {
     G4AccumulableManager::Instance()->Reset();
-    gTotalScint = 0;
-    gEscape = 0;
-    gDetectedPhotons = 0;  // RESET GLOBAL COUNTER
-    
+    auto shard = Shard::Instance();
+    auto checkpoint = Checkpoint::Instance();
     // reset counters
     if (IsMaster()) {  
+        DepositReader::Rewind();
+        // earlier segments of a checkpointed run, then event offset and
+        // master seeds, before the workers are seeded
+        checkpoint->BeginOfSegment(*fRun, aRun->GetRunID());
+        shard->BeginOfRun(
+            checkpoint->GetRunID(aRun->GetRunID()),
+            checkpoint->GetEvents(aRun->GetNumberOfEventToBeProcessed()),
+            checkpoint->GetFirstEvent());
+        auto fileName = [shard, checkpoint](const G4String& name) {
+            return checkpoint->FileName(shard->FileName(name));
+        };
+        if (!fHitFile.empty())
+            PhotonHitStream::Instance()->Open(fileName(fHitFile));
+        if (!fTupleFile.empty())
+            EventTuple::Instance()->Open(fileName(fTupleFile),
+                                         fTupleCompress);
+        if (!fDepositFile.empty())
+            DepositStream::Instance()->Open(fileName(fDepositFile),
+                                            fDepositCompress);
+        if (checkpoint->IsFirstSegment()) {
+            PrecisionMonitor::Instance()->Reset();
+            Benchmark::Instance()->BeginOfRun();
+        }
+        ProgressMonitor::Instance()->Start(
+            aRun->GetNumberOfEventToBeProcessed());
     }
     // copy primary generator info
     if (fPrimary) {
         auto gun = fPrimary->GetParticleGun();
+        auto spectrum = fPrimary->GetSpectrum();
         fRun->SetPrimary(
             gun->GetParticleDefinition(),
-            gun->GetParticleEnergy(),
+            spectrum ? spectrum->GetMeanEnergy() : gun->GetParticleEnergy(),
             fPrimary->GetPolarized(),
             fPrimary->GetPolarization());
+        fRun->SetSpectrum(spectrum);
     }
     // open histograms
     auto analysis = G4AnalysisManager::Instance();
+    analysis->SetFileName(shard->FileName(analysis->GetFileName()));
     if (analysis->IsActive())
         analysis->OpenFile();
 }
@@ -61,24 +130,223 @@ void RunAction::BeginOfRunAction(const G4Run*)
 void RunAction::EndOfRunAction(const G4Run* aRun)
 {
     auto analysis = G4AnalysisManager::Instance();
+    // every thread that filled events hands over its last rows
+    EventTuple::Instance()->FlushThread();
+    DepositStream::Instance()->FlushThread();
     if (IsMaster()) {
+        ProgressMonitor::Instance()->Stop();
         G4AccumulableManager::Instance()->Merge();
         auto run = static_cast<const Run*>(aRun);
-        
-        G4cout << "\n=== CsI SCINTILLATION SUMMARY ===\n";
-        G4cout << "Total scintillation photons created: " << gTotalScint << "\n";
-        G4cout << "Total photons that escaped CsI:     " << gEscape << "\n";
-        G4cout << "Photons exiting CsI +Z face:        " << run->GetExitPlusZ() << "\n";
-        
-        // USE BOTH COUNTERS
-        G4cout << "Photons detected at PD (global):      " << gDetectedPhotons << "\n";
-        
-        auto Ndet = gDetectedPhotons;  // USE GLOBAL COUNTER
-        G4double QE = 0.9;
-        G4cout << "Estimated electrons: " << (QE * Ndet) << G4endl;
-        G4cout << "====================================\n\n";
-        
+        // workers are done, so the hit rings can be drained for good
+        PhotonHitStream::Instance()->Close();
+        EventTuple::Instance()->Close();
+        DepositStream::Instance()->Close();
+        // more segments to come: the run goes on from the checkpoint
+        if (!Checkpoint::Instance()->EndOfSegment(*run)) {
+            if (analysis->IsActive()) {
+                analysis->Write();
+                analysis->CloseFile();
+            }
+            return;
+        }
+
+        run->PrintScintillationSummary();
+
+        // raw merged content, before the normalization of EndOfRun
+        auto shard = Shard::Instance();
+        if (shard->IsActive()) {
+            RunProgress header;
+            header.fRunID = shard->GetRunID();
+            header.fShardIndex = shard->GetIndex();
+            header.fShardCount = shard->GetCount();
+            RunState::Write(shard->StateFileName(header.fRunID), *run,
+                            header);
+        }
         run->EndOfRun();
+        // the events of this process only
+        const auto& resumed = Checkpoint::Instance()->GetResumed();
+        Benchmark::Instance()->EndOfRun(
+            run->GetNumberOfEvent() - resumed.fEvents,
+            run->GetOpticalSteps() - resumed.fOpticalSteps,
+            run->GetOpticalTracks() - resumed.fOpticalTracks);
+        PrecisionMonitor::Instance()->Print();
+        Report(run);
     }
     if (analysis->IsActive()) { analysis->Write(); analysis->CloseFile(); }
-}
\ No newline at end of file
+}
+
+void RunAction::Report(const Run* run) const
+{
+    auto shard = Shard::Instance();
+    std::ios::fmtflags mode = G4cout.flags();
+    G4cout << "Reproducibility digest: " << std::hex << std::setfill('0')
+           << std::setw(16) << run->GetEventDigest() << std::setfill(' ')
+           << " (" << std::dec << run->GetNumberOfEvent() << " events)"
+           << G4endl;
+    G4cout.flags(mode);
+    if (auto profile = run->GetStepProfile()) {
+        profile->Print(fProfileRows);
+        if (!fProfileFile.empty())
+            profile->Write(shard->FileName(fProfileFile));
+    }
+    if (auto timing = run->GetEventTiming()) {
+        timing->Print();
+        if (!fSlowEventFile.empty())
+            timing->Write(shard->FileName(fSlowEventFile));
+    }
+    if (!fResolutionFile.empty() && run->GetSpreadMap().GetSum() > 0.) {
+        SpreadFunction resolution(run->GetSpreadMap());
+        resolution.Print();
+        resolution.Write(shard->FileName(fResolutionFile));
+    }
+    if (!fArrivalFile.empty())
+        run->WriteArrivalSpectrum(shard->FileName(fArrivalFile));
+    if (run->GetRecordEvents()) Reweight(run);
+    if (!fResponseFile.empty() && run->GetResponse().IsConfigured()) {
+        run->GetResponse().Print();
+        run->GetResponse().Write(shard->FileName(fResponseFile));
+    }
+}
+
+void RunAction::SetResponseGeneration(const G4String& fileName, G4int nx,
+                                      G4int ny, G4int nz,
+                                      G4int photonsPerEvent)
+{
+    fResponseFile = fileName;
+    fResponseVoxels[0] = nx;
+    fResponseVoxels[1] = ny;
+    fResponseVoxels[2] = nz;
+    if (fPrimary)
+        fPrimary->SetResponsePhotons(fileName.empty() ? 0 : photonsPerEvent);
+}
+
+void RunAction::SetResponseModel(const G4String& fileName)
+{
+    if (fileName == "none")
+        fResponseModel.reset();
+    else
+        fResponseModel = ResponseMatrix::Load(fileName);
+}
+
+std::vector<OpticalReweighter::Target> RunAction::MakeOpticalTargets() const
+{
+    std::vector<OpticalReweighter::Target> targets;
+    auto det = static_cast<const DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+
+    G4double simulated = det->GetWrapReflectivity();
+    if (!fReflectivityTargets.empty() && simulated <= 0.) {
+        G4Exception("RunAction::MakeOpticalTargets", "OpNovice2_018",
+            JustWarning,
+            "Wrap reflectivity targets need a reflectivity > 0 in the "
+            "simulation; ignored.");
+    }
+    else {
+        // a photon reflected n times on the wrap: weight (R / R_sim)^n
+        for (G4double r : fReflectivityTargets) {
+            std::ostringstream name;
+            name << "wrap R = " << r;
+            G4double ratio = r / simulated;
+            targets.push_back({ name.str(), [ratio](const DetectedPhoton& p) {
+                return std::pow(ratio, p.fWrapReflections);
+            } });
+        }
+    }
+
+    // survival exp(-L / lambda) over the path L in the CsI; the simulated
+    // absorption length comes from the material, infinite if not set
+    auto mpt = det->GetTankMaterial()->GetMaterialPropertiesTable();
+    const G4MaterialPropertyVector* absLength =
+        mpt ? mpt->GetProperty(kABSLENGTH) : nullptr;
+    auto inverse = [absLength](G4double energy) {
+        return absLength ? 1. / absLength->Value(energy) : 0.;
+    };
+    for (G4double s : fAbsorptionScaleTargets) {
+        std::ostringstream name;
+        name << "abs. length x " << s;
+        targets.push_back({ name.str(), [inverse, s](const DetectedPhoton& p) {
+            return G4Exp(p.fPathLength * inverse(p.fEnergy) * (1. - 1. / s));
+        } });
+    }
+    for (const auto& table : fAbsorptionTableTargets) {
+        targets.push_back({ "abs. length " + table->GetName(),
+            [inverse, table](const DetectedPhoton& p) {
+                return G4Exp(p.fPathLength * (inverse(p.fEnergy) -
+                                              1. / table->Value(p.fEnergy)));
+            } });
+    }
+
+    // the weight of a detected photon is the probability that it makes an
+    // electron; exact when the photodiode is a perfect absorber
+    for (const auto& table : fQuantumEfficiencyTargets) {
+        targets.push_back({ "QE " + table->GetName(),
+            [table](const DetectedPhoton& p) {
+                return table->Value(CLHEP::h_Planck * CLHEP::c_light /
+                                    p.fEnergy);
+            } });
+    }
+    if (IsMaster() && !fQuantumEfficiencyTargets.empty() &&
+        !det->GetPDPerfectAbsorber()) {
+        G4Exception("RunAction::MakeOpticalTargets", "OpNovice2_020",
+            JustWarning,
+            "QE targets assume /opnovice2/pdPerfectAbsorber; with the "
+            "tabulated surface, photons reflected by the photodiode are "
+            "no arrivals, so a QE curve that includes the reflection "
+            "loss counts it twice.");
+    }
+    return targets;
+}
+
+void RunAction::AddAbsorptionTableTarget(const G4String& fileName)
+{
+    fAbsorptionTableTargets.push_back(
+        OpticalTable::Load(fileName, CLHEP::eV, CLHEP::mm));
+}
+
+void RunAction::AddQuantumEfficiencyTarget(const G4String& fileName)
+{
+    fQuantumEfficiencyTargets.push_back(
+        OpticalTable::Load(fileName, CLHEP::nm, 1.));
+}
+
+void RunAction::AddReweightTarget(const G4String& fileName)
+{
+    fReweightTargets.push_back(XraySpectrum::Load(fileName));
+}
+
+void RunAction::Reweight(const Run* run) const
+{
+    const auto& reference = run->GetSpectrum();
+    if (!reference) {
+        G4Exception("RunAction::Reweight", "OpNovice2_009", JustWarning,
+            "Reweighting needs a run with /opnovice2/gun/spectrum or "
+            "/opnovice2/gun/flatSpectrum; no per-event results kept.");
+        return;
+    }
+    if (!fEventFile.empty())
+        SpectralReweighter::WriteEvents(
+            Shard::Instance()->FileName(fEventFile), *reference,
+            run->GetEventRecords());
+    if (fReweightTargets.empty()) return;
+
+    SpectralReweighter reweighter(reference);
+    std::vector<SpectralReweighter::Result> results;
+    for (const auto& target : fReweightTargets)
+        results.push_back(reweighter.Reweight(run->GetEventRecords(), *target));
+    SpectralReweighter::Print(results);
+}
+
+void RunAction::ReweightEventFile(const G4String& fileName) const
+{
+    std::vector<EventRecord> records;
+    auto reference = SpectralReweighter::ReadEvents(fileName, records);
+    if (!reference) return;
+    G4cout << "Reweighting " << records.size() << " events from "
+           << fileName << G4endl;
+
+    SpectralReweighter reweighter(reference);
+    std::vector<SpectralReweighter::Result> results;
+    for (const auto& target : fReweightTargets)
+        results.push_back(reweighter.Reweight(records, *target));
+    SpectralReweighter::Print(results);
+}
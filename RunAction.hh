@@ -5,10 +5,19 @@
 #include "G4UserRunAction.hh"
 #include "G4Accumulable.hh"
 #include "G4AccumulableManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "OpticalReweighter.hh"
+
+#include <memory>
+#include <vector>
 
 class Run;
 class HistoManager;
 class PrimaryGeneratorAction;
+class OpticalTable;
+class ResponseMatrix;
+class RunMessenger;
+class XraySpectrum;
 
 class RunAction : public G4UserRunAction
 {
@@ -23,10 +32,124 @@ public:
     void AddPhotonToExitCount() { fExitPhotonCount += 1; }
     G4int GetExitPhotonCount() const { return fExitPhotonCount.GetValue(); }
 
+    // spectral reweighting
+    void AddReweightTarget(const G4String& fileName);
+    void ClearReweightTargets() { fReweightTargets.clear(); }
+    void SetEventFile(const G4String& fileName) { fEventFile = fileName; }
+    void ReweightEventFile(const G4String& fileName) const;
+    // optical reweighting of detected photons, applied during the run
+    void AddReflectivityTarget(G4double r) {
+        fReflectivityTargets.push_back(r);
+    }
+    // absorption length scaled by s, or replaced by a table (eV, mm)
+    void AddAbsorptionScaleTarget(G4double s) {
+        fAbsorptionScaleTargets.push_back(s);
+    }
+    void AddAbsorptionTableTarget(const G4String& fileName);
+    // photodiode QE curve (nm, fraction) giving electrons per event
+    void AddQuantumEfficiencyTarget(const G4String& fileName);
+    void ClearOpticalTargets() {
+        fReflectivityTargets.clear();
+        fAbsorptionScaleTargets.clear();
+        fAbsorptionTableTargets.clear();
+        fQuantumEfficiencyTargets.clear();
+    }
+
+    // binary stream of detected photons, opened by the master for each run
+    void SetHitFile(const G4String& fileName) { fHitFile = fileName; }
+    // per-event summary ntuple
+    void SetTupleFile(const G4String& fileName, G4bool compress) {
+        fTupleFile = fileName;
+        fTupleCompress = compress;
+    }
+    // PSF/LSF/MTF table written at end of run
+    void SetResolutionFile(const G4String& fileName) {
+        fResolutionFile = fileName;
+    }
+    void SetResolutionBinning(G4int n, G4double halfWidth) {
+        fResolutionBins = n;
+        fResolutionHalfWidth = halfWidth;
+    }
+    // wavelength spectrum arriving at the photodiode, written at end of run
+    void SetArrivalFile(const G4String& fileName) {
+        fArrivalFile = fileName;
+    }
+    void SetArrivalBinning(G4int n, G4double lambdaMin, G4double lambdaMax) {
+        fArrivalBins = n;
+        fArrivalMin = lambdaMin;
+        fArrivalMax = lambdaMax;
+    }
+
+    // step and time profile per particle, process and volume
+    void SetProfile(G4bool val) { fProfile = val; }
+    void SetProfileFile(const G4String& fileName) { fProfileFile = fileName; }
+    void SetProfileRows(G4int n) { fProfileRows = n; }
+
+    // wall time per event; the slowest events are kept for replay
+    void SetEventTiming(G4bool val) { fEventTiming = val; }
+    void SetSlowestEvents(G4int n) { fSlowestEvents = n; }
+    void SetSlowEventFile(const G4String& fileName) {
+        fSlowEventFile = fileName;
+    }
+
+    // stage 1 of the two-stage pipeline: energy deposits only
+    void SetDepositFile(const G4String& fileName, G4bool compress) {
+        fDepositFile = fileName;
+        fDepositCompress = compress;
+    }
+
+    // calibration runs: photons emitted voxel by voxel, response to FILE
+    void SetResponseGeneration(const G4String& fileName, G4int nx, G4int ny,
+                               G4int nz, G4int photonsPerEvent);
+    void SetResponseTimeBinning(G4int n, G4double tMax) {
+        fResponseTimeBins = n;
+        fResponseTmax = tMax;
+    }
+    // fold scintillation with a response file instead of tracking photons
+    void SetResponseModel(const G4String& fileName);
+
+    // master: reports and output files of a merged run, after
+    // Run::EndOfRun; also used by OpNovice2Merge on the sum of the shards
+    void Report(const Run* run) const;
+
 private:
+    void Reweight(const Run* run) const;
+    std::vector<OpticalReweighter::Target> MakeOpticalTargets() const;
+
     Run* fRun = nullptr;
     HistoManager* fHistoManager = nullptr;
     PrimaryGeneratorAction* fPrimary = nullptr;
+    RunMessenger* fRunMessenger = nullptr;
+
+    std::vector<std::shared_ptr<const XraySpectrum>> fReweightTargets;
+    G4String fEventFile;
+    std::vector<G4double> fReflectivityTargets;
+    std::vector<G4double> fAbsorptionScaleTargets;
+    std::vector<std::shared_ptr<const OpticalTable>> fAbsorptionTableTargets;
+    std::vector<std::shared_ptr<const OpticalTable>> fQuantumEfficiencyTargets;
+    G4String fHitFile;
+    G4String fTupleFile;
+    G4bool fTupleCompress = true;
+    G4String fResolutionFile;
+    G4int fResolutionBins = 128;
+    G4double fResolutionHalfWidth = 0.064 * CLHEP::mm;
+    G4String fArrivalFile;
+    G4int fArrivalBins = 800;
+    G4double fArrivalMin = 200. * CLHEP::nm;
+    G4double fArrivalMax = 1000. * CLHEP::nm;
+    G4bool fProfile = false;
+    G4String fProfileFile;
+    G4int fProfileRows = 20;
+    G4bool fEventTiming = false;
+    G4int fSlowestEvents = 10;
+    G4String fSlowEventFile;
+    G4String fDepositFile;
+    G4bool fDepositCompress = true;
+    G4String fResponseFile;
+    G4int fResponseVoxels[3] = { 1, 1, 1 };
+    G4int fResponseTimeBins = 200;
+    G4double fResponseTmax = 1. * CLHEP::ns;
+    std::shared_ptr<const ResponseMatrix> fResponseModel;
 
     G4Accumulable<G4int> fExitPhotonCount{ 0 };
 
@@ -0,0 +1,650 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/RunMessenger.cc
+/// \brief Implementation of the RunMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RunMessenger.hh"
+
+#include "Benchmark.hh"
+#include "Checkpoint.hh"
+#include "PrecisionMonitor.hh"
+#include "ProgressMonitor.hh"
+#include "RunAction.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIdirectory.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunMessenger::RunMessenger(RunAction* runAction)
+  : G4UImessenger()
+  , fRunAction(runAction)
+{
+  fReweightDir = new G4UIdirectory("/opnovice2/reweight/");
+  fReweightDir->SetGuidance("Reweighting of a run to other primary spectra.");
+
+  fReweightTargetCmd =
+    new G4UIcmdWithAString("/opnovice2/reweight/target", this);
+  fReweightTargetCmd->SetGuidance("Add a target spectrum file.");
+  fReweightTargetCmd->SetGuidance(
+    "Per-event results are kept and reweighted at end of run.");
+  fReweightTargetCmd->SetParameterName("fileName", false);
+  fReweightTargetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearTargetsCmd =
+    new G4UIcmdWithoutParameter("/opnovice2/reweight/clearTargets", this);
+  fClearTargetsCmd->SetGuidance("Remove all target spectra.");
+  fClearTargetsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEventFileCmd = new G4UIcmdWithAString("/opnovice2/reweight/eventFile", this);
+  fEventFileCmd->SetGuidance("Write per-event records with the true energy");
+  fEventFileCmd->SetGuidance(" to this file at end of run ('none' to stop).");
+  fEventFileCmd->SetParameterName("fileName", false);
+  fEventFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fApplyCmd = new G4UIcmdWithAString("/opnovice2/reweight/apply", this);
+  fApplyCmd->SetGuidance("Reweight a stored event file to all targets,");
+  fApplyCmd->SetGuidance(" without simulating.");
+  fApplyCmd->SetParameterName("fileName", false);
+  fApplyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fApplyCmd->SetToBeBroadcasted(false);
+
+  fReflectivityCmd =
+    new G4UIcmdWithAString("/opnovice2/reweight/wrapReflectivity", this);
+  fReflectivityCmd->SetGuidance("Add wrap reflectivity targets R1 [R2 ...].");
+  fReflectivityCmd->SetGuidance("Detected photons get the weight (R/R_sim)^n");
+  fReflectivityCmd->SetGuidance(" for n wrap reflections; simulate with");
+  fReflectivityCmd->SetGuidance(" /opnovice2/wrapReflectivity 1 for the");
+  fReflectivityCmd->SetGuidance(" smallest errors over the whole curve.");
+  fReflectivityCmd->SetParameterName("reflectivities", false);
+  fReflectivityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAbsScaleCmd =
+    new G4UIcmdWithAString("/opnovice2/reweight/absLengthScale", this);
+  fAbsScaleCmd->SetGuidance("Add targets with the CsI absorption length");
+  fAbsScaleCmd->SetGuidance(" scaled by s1 [s2 ...]. Detected photons get");
+  fAbsScaleCmd->SetGuidance(" exp(L/lambda_sim - L/lambda) for their path");
+  fAbsScaleCmd->SetGuidance(" length L in the CsI.");
+  fAbsScaleCmd->SetParameterName("scales", false);
+  fAbsScaleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAbsTableCmd =
+    new G4UIcmdWithAString("/opnovice2/reweight/absLengthFile", this);
+  fAbsTableCmd->SetGuidance("Add a target absorption spectrum: two columns,");
+  fAbsTableCmd->SetGuidance(" photon energy [eV] and absorption length [mm].");
+  fAbsTableCmd->SetParameterName("fileName", false);
+  fAbsTableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fQETableCmd = new G4UIcmdWithAString("/opnovice2/reweight/qeFile", this);
+  fQETableCmd->SetGuidance("Add a photodiode quantum efficiency curve: two");
+  fQETableCmd->SetGuidance(" columns, wavelength [nm] and QE (0..1). Use");
+  fQETableCmd->SetGuidance(" with /opnovice2/pdPerfectAbsorber.");
+  fQETableCmd->SetParameterName("fileName", false);
+  fQETableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearOpticalCmd =
+    new G4UIcmdWithoutParameter("/opnovice2/reweight/clearOptical", this);
+  fClearOpticalCmd->SetGuidance("Remove all optical reweighting targets.");
+  fClearOpticalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fHitsDir = new G4UIdirectory("/opnovice2/hits/");
+  fHitsDir->SetGuidance("Output of individual detected photons.");
+
+  fHitFileCmd = new G4UIcmdWithAString("/opnovice2/hits/file", this);
+  fHitFileCmd->SetGuidance("Stream every detected photon to this binary");
+  fHitFileCmd->SetGuidance(" file during the next runs ('none' to stop).");
+  fHitFileCmd->SetParameterName("fileName", false);
+  fHitFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fHitFileCmd->SetToBeBroadcasted(false);
+
+  fTupleDir = new G4UIdirectory("/opnovice2/tuple/");
+  fTupleDir->SetGuidance("Per-event summary ntuple.");
+
+  fTupleFileCmd = new G4UIcommand("/opnovice2/tuple/file", this);
+  fTupleFileCmd->SetGuidance("Write one row per event to this columnar");
+  fTupleFileCmd->SetGuidance(" file during the next runs ('none' to stop).");
+  auto tupleNamePrm = new G4UIparameter("fileName", 's', false);
+  fTupleFileCmd->SetParameter(tupleNamePrm);
+  auto compressPrm = new G4UIparameter("compress", 'b', true);
+  compressPrm->SetDefaultValue("true");
+  fTupleFileCmd->SetParameter(compressPrm);
+  fTupleFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTupleFileCmd->SetToBeBroadcasted(false);
+
+  fResolutionDir = new G4UIdirectory("/opnovice2/resolution/");
+  fResolutionDir->SetGuidance("Point/line spread function and MTF.");
+
+  fResolutionFileCmd =
+    new G4UIcmdWithAString("/opnovice2/resolution/file", this);
+  fResolutionFileCmd->SetGuidance("Accumulate the PSF and write LSF and MTF");
+  fResolutionFileCmd->SetGuidance(" to this table at end of run ('none').");
+  fResolutionFileCmd->SetParameterName("fileName", false);
+  fResolutionFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fResolutionBinningCmd =
+    new G4UIcommand("/opnovice2/resolution/binning", this);
+  fResolutionBinningCmd->SetGuidance("PSF bins per axis and half width.");
+  auto binsPrm = new G4UIparameter("nbins", 'i', false);
+  binsPrm->SetParameterRange("nbins>1");
+  fResolutionBinningCmd->SetParameter(binsPrm);
+  auto widthPrm = new G4UIparameter("halfWidth", 'd', false);
+  widthPrm->SetParameterRange("halfWidth>0.");
+  fResolutionBinningCmd->SetParameter(widthPrm);
+  auto widthUnitPrm = new G4UIparameter("unit", 's', true);
+  widthUnitPrm->SetDefaultUnit("mm");
+  fResolutionBinningCmd->SetParameter(widthUnitPrm);
+  fResolutionBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPhotodiodeDir = new G4UIdirectory("/opnovice2/pd/");
+  fPhotodiodeDir->SetGuidance("Photons arriving at the photodiode.");
+
+  fArrivalFileCmd = new G4UIcmdWithAString("/opnovice2/pd/spectrumFile", this);
+  fArrivalFileCmd->SetGuidance("Write the wavelength spectrum of photons");
+  fArrivalFileCmd->SetGuidance(" reaching the photodiode to this table at");
+  fArrivalFileCmd->SetGuidance(" end of run ('none'), for folding with QE");
+  fArrivalFileCmd->SetGuidance(" curves offline.");
+  fArrivalFileCmd->SetParameterName("fileName", false);
+  fArrivalFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fArrivalBinningCmd = new G4UIcommand("/opnovice2/pd/spectrumBinning", this);
+  fArrivalBinningCmd->SetGuidance("Number of bins and wavelength range.");
+  auto arrivalBinsPrm = new G4UIparameter("nbins", 'i', false);
+  arrivalBinsPrm->SetParameterRange("nbins>0");
+  fArrivalBinningCmd->SetParameter(arrivalBinsPrm);
+  auto arrivalMinPrm = new G4UIparameter("min", 'd', false);
+  arrivalMinPrm->SetParameterRange("min>=0.");
+  fArrivalBinningCmd->SetParameter(arrivalMinPrm);
+  auto arrivalMaxPrm = new G4UIparameter("max", 'd', false);
+  fArrivalBinningCmd->SetParameter(arrivalMaxPrm);
+  auto arrivalUnitPrm = new G4UIparameter("unit", 's', true);
+  arrivalUnitPrm->SetDefaultUnit("nm");
+  fArrivalBinningCmd->SetParameter(arrivalUnitPrm);
+  fArrivalBinningCmd->SetRange("max>min");
+  fArrivalBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDepositsDir = new G4UIdirectory("/opnovice2/deposits/");
+  fDepositsDir->SetGuidance("Stage 1 of the two-stage pipeline.");
+
+  fDepositFileCmd = new G4UIcommand("/opnovice2/deposits/file", this);
+  fDepositFileCmd->SetGuidance("Write every energy deposit in the CsI to");
+  fDepositFileCmd->SetGuidance(" this file and do not track optical photons");
+  fDepositFileCmd->SetGuidance(" during the next runs ('none' to stop).");
+  fDepositFileCmd->SetGuidance("Replay it with /opnovice2/gun/deposits.");
+  auto depositNamePrm = new G4UIparameter("fileName", 's', false);
+  fDepositFileCmd->SetParameter(depositNamePrm);
+  auto depositCompressPrm = new G4UIparameter("compress", 'b', true);
+  depositCompressPrm->SetDefaultValue("true");
+  fDepositFileCmd->SetParameter(depositCompressPrm);
+  fDepositFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fDepositFileCmd->SetToBeBroadcasted(false);
+
+  fResponseDir = new G4UIdirectory("/opnovice2/response/");
+  fResponseDir->SetGuidance("Optical response per emission voxel.");
+
+  fResponseGenerateCmd = new G4UIcommand("/opnovice2/response/generate", this);
+  fResponseGenerateCmd->SetGuidance("Emit scintillation photons voxel by");
+  fResponseGenerateCmd->SetGuidance(" voxel (one voxel per event) and write");
+  fResponseGenerateCmd->SetGuidance(" the collection probability and arrival");
+  fResponseGenerateCmd->SetGuidance(" time to FILE at end of run ('none').");
+  auto responseNamePrm = new G4UIparameter("fileName", 's', false);
+  fResponseGenerateCmd->SetParameter(responseNamePrm);
+  for(const char* axis : { "nx", "ny", "nz" })
+  {
+    auto voxelPrm = new G4UIparameter(axis, 'i', true);
+    voxelPrm->SetParameterRange(G4String(axis) + ">0");
+    voxelPrm->SetDefaultValue(axis[1] == 'z' ? 20 : 1);
+    fResponseGenerateCmd->SetParameter(voxelPrm);
+  }
+  auto photonsPrm = new G4UIparameter("photonsPerEvent", 'i', true);
+  photonsPrm->SetParameterRange("photonsPerEvent>0");
+  photonsPrm->SetDefaultValue(1000);
+  fResponseGenerateCmd->SetParameter(photonsPrm);
+  fResponseGenerateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fResponseTimeBinningCmd =
+    new G4UIcommand("/opnovice2/response/timeBinning", this);
+  fResponseTimeBinningCmd->SetGuidance("Arrival-time bins and range;");
+  fResponseTimeBinningCmd->SetGuidance(" the last bin takes the overflow.");
+  auto timeBinsPrm = new G4UIparameter("nbins", 'i', false);
+  timeBinsPrm->SetParameterRange("nbins>0");
+  fResponseTimeBinningCmd->SetParameter(timeBinsPrm);
+  auto tMaxPrm = new G4UIparameter("tMax", 'd', false);
+  tMaxPrm->SetParameterRange("tMax>0.");
+  fResponseTimeBinningCmd->SetParameter(tMaxPrm);
+  auto timeUnitPrm = new G4UIparameter("unit", 's', true);
+  timeUnitPrm->SetDefaultUnit("ns");
+  fResponseTimeBinningCmd->SetParameter(timeUnitPrm);
+  fResponseTimeBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fResponseApplyCmd =
+    new G4UIcmdWithAString("/opnovice2/response/apply", this);
+  fResponseApplyCmd->SetGuidance("Do not track optical photons; count each");
+  fResponseApplyCmd->SetGuidance(" scintillation photon as detected with");
+  fResponseApplyCmd->SetGuidance(" the probability of its voxel in FILE.");
+  fResponseApplyCmd->SetGuidance("'none' goes back to full tracking.");
+  fResponseApplyCmd->SetParameterName("fileName", false);
+  fResponseApplyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRunDir = new G4UIdirectory("/opnovice2/run/");
+  fRunDir->SetGuidance("Run control.");
+
+  fTargetPrecisionCmd =
+    new G4UIcommand("/opnovice2/run/targetPrecision", this);
+  fTargetPrecisionCmd->SetGuidance("Stop the run when the relative standard");
+  fTargetPrecisionCmd->SetGuidance(" error of the observable is reached.");
+  fTargetPrecisionCmd->SetGuidance("/run/beamOn gives the maximum events.");
+  fTargetPrecisionCmd->SetGuidance("A precision of 0 disables the check.");
+  auto precisionPrm = new G4UIparameter("precision", 'd', false);
+  precisionPrm->SetParameterRange("precision>=0.");
+  fTargetPrecisionCmd->SetParameter(precisionPrm);
+  auto observablePrm = new G4UIparameter("observable", 's', true);
+  observablePrm->SetParameterCandidates("detected efficiency");
+  observablePrm->SetDefaultValue("detected");
+  fTargetPrecisionCmd->SetParameter(observablePrm);
+  auto batchPrm = new G4UIparameter("batch", 'i', true);
+  batchPrm->SetParameterRange("batch>0");
+  batchPrm->SetDefaultValue(1000);
+  fTargetPrecisionCmd->SetParameter(batchPrm);
+  fTargetPrecisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTargetPrecisionCmd->SetToBeBroadcasted(false);
+
+  fProfileDir = new G4UIdirectory("/opnovice2/profile/");
+  fProfileDir->SetGuidance("Steps and time per particle, process and volume.");
+
+  fProfileCmd = new G4UIcmdWithABool("/opnovice2/profile/enable", this);
+  fProfileCmd->SetGuidance("Profile the next runs: every step is timed and");
+  fProfileCmd->SetGuidance(" counted per (particle, process defining the");
+  fProfileCmd->SetGuidance(" step, volume); the table is printed at end");
+  fProfileCmd->SetGuidance(" of run.");
+  fProfileCmd->SetParameterName("enable", true);
+  fProfileCmd->SetDefaultValue(true);
+  fProfileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fProfileFileCmd = new G4UIcmdWithAString("/opnovice2/profile/file", this);
+  fProfileFileCmd->SetGuidance("Also write the whole table, sorted by time,");
+  fProfileFileCmd->SetGuidance(" to this file ('none' to stop).");
+  fProfileFileCmd->SetParameterName("fileName", false);
+  fProfileFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProfileFileCmd->SetToBeBroadcasted(false);
+
+  fProfileRowsCmd = new G4UIcmdWithAnInteger("/opnovice2/profile/rows", this);
+  fProfileRowsCmd->SetGuidance("Number of rows printed (default 20).");
+  fProfileRowsCmd->SetParameterName("rows", false);
+  fProfileRowsCmd->SetRange("rows>0");
+  fProfileRowsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProfileRowsCmd->SetToBeBroadcasted(false);
+
+  fTimingDir = new G4UIdirectory("/opnovice2/timing/");
+  fTimingDir->SetGuidance("Wall time per event and the slowest events.");
+
+  fTimingCmd = new G4UIcmdWithABool("/opnovice2/timing/enable", this);
+  fTimingCmd->SetGuidance("Time every event of the next runs; a log-binned");
+  fTimingCmd->SetGuidance(" histogram and the slowest events are printed at");
+  fTimingCmd->SetGuidance(" end of run.");
+  fTimingCmd->SetParameterName("enable", true);
+  fTimingCmd->SetDefaultValue(true);
+  fTimingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSlowestCmd = new G4UIcmdWithAnInteger("/opnovice2/timing/slowest", this);
+  fSlowestCmd->SetGuidance("Number of slowest events kept (default 10).");
+  fSlowestCmd->SetParameterName("K", false);
+  fSlowestCmd->SetRange("K>=0");
+  fSlowestCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSlowFileCmd = new G4UIcmdWithAString("/opnovice2/timing/file", this);
+  fSlowFileCmd->SetGuidance("Write the slowest events, with the random-engine");
+  fSlowFileCmd->SetGuidance(" state each started from, to this file; run");
+  fSlowFileCmd->SetGuidance(" them again with /opnovice2/gun/replay FILE.");
+  fSlowFileCmd->SetGuidance("Use 'none' to stop.");
+  fSlowFileCmd->SetParameterName("fileName", false);
+  fSlowFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSlowFileCmd->SetToBeBroadcasted(false);
+
+  fBenchDir = new G4UIdirectory("/opnovice2/bench/");
+  fBenchDir->SetGuidance("Throughput reports (see bench.cmake).");
+
+  fBenchFileCmd = new G4UIcmdWithAString("/opnovice2/bench/file", this);
+  fBenchFileCmd->SetGuidance("Append events/s, optical steps/s, photons/s,");
+  fBenchFileCmd->SetGuidance(" init time and peak RSS of every run to this");
+  fBenchFileCmd->SetGuidance(" file as one JSON line ('none' to stop).");
+  fBenchFileCmd->SetParameterName("fileName", false);
+  fBenchFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBenchFileCmd->SetToBeBroadcasted(false);
+
+  fBenchLabelCmd = new G4UIcmdWithAString("/opnovice2/bench/label", this);
+  fBenchLabelCmd->SetGuidance("Workload name written with the reports.");
+  fBenchLabelCmd->SetParameterName("label", false);
+  fBenchLabelCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBenchLabelCmd->SetToBeBroadcasted(false);
+
+  fMonitorDir = new G4UIdirectory("/opnovice2/monitor/");
+  fMonitorDir->SetGuidance("Live progress of the runs.");
+
+  fMonitorIntervalCmd =
+    new G4UIcmdWithADoubleAndUnit("/opnovice2/monitor/interval", this);
+  fMonitorIntervalCmd->SetGuidance("Print events/s, photons/s, imbalance");
+  fMonitorIntervalCmd->SetGuidance(" between threads and ETA this often");
+  fMonitorIntervalCmd->SetGuidance(" during each run (0 to stop).");
+  fMonitorIntervalCmd->SetParameterName("interval", false);
+  fMonitorIntervalCmd->SetRange("interval>=0.");
+  fMonitorIntervalCmd->SetUnitCategory("Time");
+  fMonitorIntervalCmd->SetDefaultUnit("s");
+  fMonitorIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMonitorIntervalCmd->SetToBeBroadcasted(false);
+
+  fMonitorFileCmd = new G4UIcmdWithAString("/opnovice2/monitor/file", this);
+  fMonitorFileCmd->SetGuidance("Also append every sample to this CSV file");
+  fMonitorFileCmd->SetGuidance(" ('none' to stop).");
+  fMonitorFileCmd->SetParameterName("fileName", false);
+  fMonitorFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMonitorFileCmd->SetToBeBroadcasted(false);
+
+  fCheckpointDir = new G4UIdirectory("/opnovice2/checkpoint/");
+  fCheckpointDir->SetGuidance("Checkpoints of long runs (OpNovice2 --resume).");
+
+  fCheckpointFileCmd =
+    new G4UIcmdWithAString("/opnovice2/checkpoint/file", this);
+  fCheckpointFileCmd->SetGuidance("Run state written after every segment");
+  fCheckpointFileCmd->SetGuidance(" of /opnovice2/checkpoint/beamOn, and read");
+  fCheckpointFileCmd->SetGuidance(" back with --resume ('none' to stop).");
+  fCheckpointFileCmd->SetParameterName("fileName", false);
+  fCheckpointFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCheckpointFileCmd->SetToBeBroadcasted(false);
+
+  fCheckpointEveryCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/checkpoint/every", this);
+  fCheckpointEveryCmd->SetGuidance("Events between checkpoints (0: none).");
+  fCheckpointEveryCmd->SetParameterName("events", false);
+  fCheckpointEveryCmd->SetRange("events>=0");
+  fCheckpointEveryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCheckpointEveryCmd->SetToBeBroadcasted(false);
+
+  fCheckpointBeamOnCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/checkpoint/beamOn", this);
+  fCheckpointBeamOnCmd->SetGuidance("/run/beamOn in segments, with a");
+  fCheckpointBeamOnCmd->SetGuidance(" checkpoint after each; with --resume,");
+  fCheckpointBeamOnCmd->SetGuidance(" starts from the checkpoint if any.");
+  fCheckpointBeamOnCmd->SetParameterName("events", false);
+  fCheckpointBeamOnCmd->SetRange("events>=0");
+  fCheckpointBeamOnCmd->AvailableForStates(G4State_Idle);
+  fCheckpointBeamOnCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunMessenger::~RunMessenger()
+{
+  delete fReweightTargetCmd;
+  delete fClearTargetsCmd;
+  delete fEventFileCmd;
+  delete fApplyCmd;
+  delete fReflectivityCmd;
+  delete fAbsScaleCmd;
+  delete fAbsTableCmd;
+  delete fQETableCmd;
+  delete fClearOpticalCmd;
+  delete fReweightDir;
+  delete fHitFileCmd;
+  delete fHitsDir;
+  delete fTupleFileCmd;
+  delete fTupleDir;
+  delete fResolutionFileCmd;
+  delete fResolutionBinningCmd;
+  delete fResolutionDir;
+  delete fArrivalFileCmd;
+  delete fArrivalBinningCmd;
+  delete fPhotodiodeDir;
+  delete fDepositFileCmd;
+  delete fDepositsDir;
+  delete fResponseGenerateCmd;
+  delete fResponseTimeBinningCmd;
+  delete fResponseApplyCmd;
+  delete fResponseDir;
+  delete fTargetPrecisionCmd;
+  delete fRunDir;
+  delete fProfileCmd;
+  delete fProfileFileCmd;
+  delete fProfileRowsCmd;
+  delete fProfileDir;
+  delete fTimingCmd;
+  delete fSlowestCmd;
+  delete fSlowFileCmd;
+  delete fTimingDir;
+  delete fBenchFileCmd;
+  delete fBenchLabelCmd;
+  delete fBenchDir;
+  delete fMonitorIntervalCmd;
+  delete fMonitorFileCmd;
+  delete fMonitorDir;
+  delete fCheckpointFileCmd;
+  delete fCheckpointEveryCmd;
+  delete fCheckpointBeamOnCmd;
+  delete fCheckpointDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if(command == fReweightTargetCmd)
+  {
+    fRunAction->AddReweightTarget(newValue);
+  }
+  else if(command == fClearTargetsCmd)
+  {
+    fRunAction->ClearReweightTargets();
+  }
+  else if(command == fEventFileCmd)
+  {
+    fRunAction->SetEventFile(newValue == "none" ? G4String() : newValue);
+  }
+  else if(command == fApplyCmd)
+  {
+    fRunAction->ReweightEventFile(newValue);
+  }
+  else if(command == fReflectivityCmd)
+  {
+    std::istringstream is(newValue);
+    G4double r;
+    while(is >> r)
+      fRunAction->AddReflectivityTarget(r);
+  }
+  else if(command == fAbsScaleCmd)
+  {
+    std::istringstream is(newValue);
+    G4double s;
+    while(is >> s)
+      fRunAction->AddAbsorptionScaleTarget(s);
+  }
+  else if(command == fAbsTableCmd)
+  {
+    fRunAction->AddAbsorptionTableTarget(newValue);
+  }
+  else if(command == fQETableCmd)
+  {
+    fRunAction->AddQuantumEfficiencyTarget(newValue);
+  }
+  else if(command == fClearOpticalCmd)
+  {
+    fRunAction->ClearOpticalTargets();
+  }
+  else if(command == fHitFileCmd)
+  {
+    fRunAction->SetHitFile(newValue == "none" ? G4String() : newValue);
+  }
+  else if(command == fTupleFileCmd)
+  {
+    std::istringstream is(newValue);
+    G4String fileName, compress;
+    is >> fileName >> compress;
+    fRunAction->SetTupleFile(fileName == "none" ? G4String() : fileName,
+                             G4UIcommand::ConvertToBool(compress));
+  }
+  else if(command == fResolutionFileCmd)
+  {
+    fRunAction->SetResolutionFile(newValue == "none" ? G4String()
+                                                     : newValue);
+  }
+  else if(command == fResolutionBinningCmd)
+  {
+    std::istringstream is(newValue);
+    G4int n;
+    G4double halfWidth;
+    G4String unit;
+    is >> n >> halfWidth >> unit;
+    fRunAction->SetResolutionBinning(n,
+                                     halfWidth * G4UIcommand::ValueOf(unit));
+  }
+  else if(command == fArrivalFileCmd)
+  {
+    fRunAction->SetArrivalFile(newValue == "none" ? G4String() : newValue);
+  }
+  else if(command == fArrivalBinningCmd)
+  {
+    std::istringstream is(newValue);
+    G4int n;
+    G4double lambdaMin, lambdaMax;
+    G4String unit;
+    is >> n >> lambdaMin >> lambdaMax >> unit;
+    G4double u = G4UIcommand::ValueOf(unit);
+    fRunAction->SetArrivalBinning(n, lambdaMin * u, lambdaMax * u);
+  }
+  else if(command == fDepositFileCmd)
+  {
+    std::istringstream is(newValue);
+    G4String fileName, compress;
+    is >> fileName >> compress;
+    fRunAction->SetDepositFile(fileName == "none" ? G4String() : fileName,
+                               G4UIcommand::ConvertToBool(compress));
+  }
+  else if(command == fResponseGenerateCmd)
+  {
+    std::istringstream is(newValue);
+    G4String fileName;
+    G4int nx, ny, nz, photons;
+    is >> fileName >> nx >> ny >> nz >> photons;
+    fRunAction->SetResponseGeneration(
+      fileName == "none" ? G4String() : fileName, nx, ny, nz, photons);
+  }
+  else if(command == fResponseTimeBinningCmd)
+  {
+    std::istringstream is(newValue);
+    G4int n;
+    G4double tMax;
+    G4String unit;
+    is >> n >> tMax >> unit;
+    fRunAction->SetResponseTimeBinning(n, tMax * G4UIcommand::ValueOf(unit));
+  }
+  else if(command == fResponseApplyCmd)
+  {
+    fRunAction->SetResponseModel(newValue);
+  }
+  else if(command == fTargetPrecisionCmd)
+  {
+    std::istringstream is(newValue);
+    G4double precision;
+    G4String observable;
+    G4int batch;
+    is >> precision >> observable >> batch;
+    PrecisionMonitor::Instance()->SetTarget(
+      precision,
+      observable == "efficiency" ? PrecisionMonitor::kEfficiency
+                                 : PrecisionMonitor::kDetected,
+      batch);
+  }
+  else if(command == fProfileCmd)
+  {
+    fRunAction->SetProfile(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if(command == fProfileFileCmd)
+  {
+    fRunAction->SetProfileFile(newValue == "none" ? G4String() : newValue);
+  }
+  else if(command == fProfileRowsCmd)
+  {
+    fRunAction->SetProfileRows(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if(command == fTimingCmd)
+  {
+    fRunAction->SetEventTiming(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if(command == fSlowestCmd)
+  {
+    fRunAction->SetSlowestEvents(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if(command == fSlowFileCmd)
+  {
+    fRunAction->SetSlowEventFile(newValue == "none" ? G4String() : newValue);
+  }
+  else if(command == fBenchFileCmd)
+  {
+    Benchmark::Instance()->SetFile(newValue == "none" ? G4String() : newValue);
+  }
+  else if(command == fBenchLabelCmd)
+  {
+    Benchmark::Instance()->SetLabel(newValue);
+  }
+  else if(command == fMonitorIntervalCmd)
+  {
+    ProgressMonitor::Instance()->SetInterval(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue) / CLHEP::s);
+  }
+  else if(command == fMonitorFileCmd)
+  {
+    ProgressMonitor::Instance()->SetFile(newValue == "none" ? G4String()
+                                                             : newValue);
+  }
+  else if(command == fCheckpointFileCmd)
+  {
+    Checkpoint::Instance()->SetFile(newValue == "none" ? G4String()
+                                                       : newValue);
+  }
+  else if(command == fCheckpointEveryCmd)
+  {
+    Checkpoint::Instance()->SetEvery(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if(command == fCheckpointBeamOnCmd)
+  {
+    Checkpoint::Instance()->BeamOn(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
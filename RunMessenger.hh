@@ -0,0 +1,123 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/RunMessenger.hh
+/// \brief Definition of the RunMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RunMessenger_h
+#define RunMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class RunAction;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+class G4UIcommand;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class RunMessenger : public G4UImessenger
+{
+ public:
+  RunMessenger(RunAction*);
+  ~RunMessenger() override;
+
+  void SetNewValue(G4UIcommand*, G4String) override;
+
+ private:
+  RunAction* fRunAction = nullptr;
+
+  G4UIdirectory* fReweightDir = nullptr;
+  G4UIcmdWithAString* fReweightTargetCmd = nullptr;
+  G4UIcmdWithoutParameter* fClearTargetsCmd = nullptr;
+  G4UIcmdWithAString* fEventFileCmd = nullptr;
+  G4UIcmdWithAString* fApplyCmd = nullptr;
+  G4UIcmdWithAString* fReflectivityCmd = nullptr;
+  G4UIcmdWithAString* fAbsScaleCmd = nullptr;
+  G4UIcmdWithAString* fAbsTableCmd = nullptr;
+  G4UIcmdWithAString* fQETableCmd = nullptr;
+  G4UIcmdWithoutParameter* fClearOpticalCmd = nullptr;
+
+  G4UIdirectory* fHitsDir = nullptr;
+  G4UIcmdWithAString* fHitFileCmd = nullptr;
+
+  G4UIdirectory* fTupleDir = nullptr;
+  G4UIcommand* fTupleFileCmd = nullptr;
+
+  G4UIdirectory* fResolutionDir = nullptr;
+  G4UIcmdWithAString* fResolutionFileCmd = nullptr;
+  G4UIcommand* fResolutionBinningCmd = nullptr;
+
+  G4UIdirectory* fPhotodiodeDir = nullptr;
+  G4UIcmdWithAString* fArrivalFileCmd = nullptr;
+  G4UIcommand* fArrivalBinningCmd = nullptr;
+
+  G4UIdirectory* fDepositsDir = nullptr;
+  G4UIcommand* fDepositFileCmd = nullptr;
+
+  G4UIdirectory* fResponseDir = nullptr;
+  G4UIcommand* fResponseGenerateCmd = nullptr;
+  G4UIcommand* fResponseTimeBinningCmd = nullptr;
+  G4UIcmdWithAString* fResponseApplyCmd = nullptr;
+
+  G4UIdirectory* fRunDir = nullptr;
+  G4UIcommand* fTargetPrecisionCmd = nullptr;
+
+  G4UIdirectory* fProfileDir = nullptr;
+  G4UIcmdWithABool* fProfileCmd = nullptr;
+  G4UIcmdWithAString* fProfileFileCmd = nullptr;
+  G4UIcmdWithAnInteger* fProfileRowsCmd = nullptr;
+
+  G4UIdirectory* fTimingDir = nullptr;
+  G4UIcmdWithABool* fTimingCmd = nullptr;
+  G4UIcmdWithAnInteger* fSlowestCmd = nullptr;
+  G4UIcmdWithAString* fSlowFileCmd = nullptr;
+
+  G4UIdirectory* fBenchDir = nullptr;
+  G4UIcmdWithAString* fBenchFileCmd = nullptr;
+  G4UIcmdWithAString* fBenchLabelCmd = nullptr;
+
+  G4UIdirectory* fMonitorDir = nullptr;
+  G4UIcmdWithADoubleAndUnit* fMonitorIntervalCmd = nullptr;
+  G4UIcmdWithAString* fMonitorFileCmd = nullptr;
+
+  G4UIdirectory* fCheckpointDir = nullptr;
+  G4UIcmdWithAString* fCheckpointFileCmd = nullptr;
+  G4UIcmdWithAnInteger* fCheckpointEveryCmd = nullptr;
+  G4UIcmdWithAnInteger* fCheckpointBeamOnCmd = nullptr;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
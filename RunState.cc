@@ -0,0 +1,229 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/RunState.cc
+/// \brief Implementation of the RunState class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RunState.hh"
+
+#include "Run.hh"
+
+#include "G4AnalysisManager.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+const char kRunStateMagic[8] = { 'O', 'P', 'N', '2', 'R', 'U', 'N', 'S' };
+const std::uint32_t kRunStateVersion = 4;
+
+void Warn(const char* where, const char* code, const G4String& what)
+{
+  G4ExceptionDescription ed;
+  ed << what;
+  G4Exception(where, code, JustWarning, ed);
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool RunState::Write(const G4String& fileName, const Run& run,
+                       const RunProgress& progress)
+{
+  G4String tmpName = fileName + ".tmp";
+  {
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    StateWriter writer(out);
+    out.write(kRunStateMagic, sizeof(kRunStateMagic));
+    writer.Put(kRunStateVersion);
+    writer.Put(progress.fRunID);
+    writer.Put(progress.fShardIndex);
+    writer.Put(progress.fShardCount);
+    writer.Put(progress.fNextRunID);
+    writer.Put(progress.fEvents);
+    writer.Put(progress.fEventsDone);
+    writer.Put(progress.fEngineState);
+    run.Save(writer);
+    SaveHistograms(writer);
+    out.flush();
+    if(!out)
+    {
+      Warn("RunState::Write", "OpNovice2_013",
+           "Error while writing " + tmpName);
+      std::remove(tmpName.c_str());
+      return false;
+    }
+  }
+#ifdef _WIN32
+  // rename does not replace an existing file here
+  std::remove(fileName.c_str());
+#else
+  // on disk before the rename makes it visible
+  int fd = open(tmpName.c_str(), O_RDONLY);
+  if(fd >= 0)
+  {
+    fsync(fd);
+    close(fd);
+  }
+#endif
+  if(std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+  {
+    Warn("RunState::Write", "OpNovice2_013",
+         "Cannot rename " + tmpName + " to " + fileName);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool RunState::Read(const G4String& fileName, Run& run,
+                      RunProgress* progress)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  StateReader reader(in);
+  RunProgress header;
+  if(!ReadHeader(reader, header))
+  {
+    Warn("RunState::Read", "OpNovice2_022",
+         fileName + " is not a run state file (version " +
+           std::to_string(kRunStateVersion) + ").");
+    return false;
+  }
+  if(progress)
+    *progress = header;
+  if(!run.Restore(reader) || !AddHistograms(reader))
+  {
+    Warn("RunState::Read", "OpNovice2_022",
+         fileName + " is truncated or does not match this setup.");
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool RunState::ReadProgress(const G4String& fileName, RunProgress& progress)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  StateReader reader(in);
+  return ReadHeader(reader, progress);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool RunState::ReadHeader(StateReader& in, RunProgress& progress)
+{
+  char magic[8] = { 0 };
+  std::uint32_t version = 0;
+  for(auto& c : magic)
+    in.Get(c);
+  in.Get(version);
+  if(!in.Good() || std::memcmp(magic, kRunStateMagic, sizeof(magic)) != 0 ||
+     version != kRunStateVersion)
+    return false;
+  in.Get(progress.fRunID);
+  in.Get(progress.fShardIndex);
+  in.Get(progress.fShardCount);
+  in.Get(progress.fNextRunID);
+  in.Get(progress.fEvents);
+  in.Get(progress.fEventsDone);
+  in.Get(progress.fEngineState);
+  return in.Good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void RunState::SaveHistograms(StateWriter& out)
+{
+  auto analysis = G4AnalysisManager::Instance();
+  G4int first   = analysis->GetFirstH1Id();
+  G4int n       = analysis->GetNofH1s();
+  out.Put(n);
+  for(G4int id = first; id < first + n; ++id)
+  {
+    auto h1    = analysis->GetH1(id, false, false);
+    G4int bins = h1 ? G4int(h1->axis().bins()) : -1;
+    out.Put(bins);
+    out.Put(G4bool(h1 && analysis->GetH1Activation(id)));
+    // bin 0 is the underflow, bins + 1 the overflow
+    for(G4int bin = 0; bin <= bins + 1 && h1; ++bin)
+    {
+      unsigned int ent;
+      G4double sw, sw2, sxw, sx2w;
+      h1->get_bin_content(bin, ent, sw, sw2, sxw, sx2w);
+      out.Put(ent);
+      out.Put(sw);
+      out.Put(sw2);
+      out.Put(sxw);
+      out.Put(sx2w);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool RunState::AddHistograms(StateReader& in)
+{
+  auto analysis = G4AnalysisManager::Instance();
+  G4int first   = analysis->GetFirstH1Id();
+  G4int n       = 0;
+  in.Get(n);
+  if(!in.Good() || n != analysis->GetNofH1s())
+    return false;
+  for(G4int id = first; id < first + n; ++id)
+  {
+    G4int bins       = 0;
+    G4bool activated = false;
+    in.Get(bins);
+    in.Get(activated);
+    auto h1 = analysis->GetH1(id, false, false);
+    if(!in.Good() || bins != (h1 ? G4int(h1->axis().bins()) : -1))
+      return false;
+    if(activated)
+      analysis->SetH1Activation(id, true);
+    for(G4int bin = 0; bin <= bins + 1 && h1; ++bin)
+    {
+      unsigned int ent, addEnt;
+      G4double sw, sw2, sxw, sx2w, addSw, addSw2, addSxw, addSx2w;
+      in.Get(addEnt);
+      in.Get(addSw);
+      in.Get(addSw2);
+      in.Get(addSxw);
+      in.Get(addSx2w);
+      h1->get_bin_content(bin, ent, sw, sw2, sxw, sx2w);
+      h1->set_bin_content(bin, ent + addEnt, sw + addSw, sw2 + addSw2,
+                          sxw + addSxw, sx2w + addSx2w);
+    }
+  }
+  return in.Good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,168 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/RunState.hh
+/// \brief Definition of the RunState class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RunState_h
+#define RunState_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+class Run;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Raw binary fields of a state file: trivially copyable values, strings
+/// and vectors (uint64 size, then the elements). Native byte order.
+class StateWriter
+{
+ public:
+  explicit StateWriter(std::ostream& out) : fOut(out) {}
+
+  template<typename T>
+  void Put(const T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "not a raw value");
+    fOut.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  void Put(const G4String& value)
+  {
+    Put(std::uint64_t(value.size()));
+    fOut.write(value.data(), value.size());
+  }
+  template<typename T>
+  void Put(const std::vector<T>& values)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "not a raw value");
+    Put(std::uint64_t(values.size()));
+    fOut.write(reinterpret_cast<const char*>(values.data()),
+               values.size() * sizeof(T));
+  }
+
+ private:
+  std::ostream& fOut;
+};
+
+class StateReader
+{
+ public:
+  explicit StateReader(std::istream& in) : fIn(in) {}
+
+  G4bool Good() const { return bool(fIn); }
+
+  template<typename T>
+  void Get(T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "not a raw value");
+    fIn.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+  void Get(G4String& value)
+  {
+    std::uint64_t n = 0;
+    Get(n);
+    if(!fIn || n > kMaxSize)
+      return Fail();
+    value.resize(n);
+    fIn.read(&value[0], n);
+  }
+  template<typename T>
+  void Get(std::vector<T>& values)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "not a raw value");
+    std::uint64_t n = 0;
+    Get(n);
+    if(!fIn || n > kMaxSize / sizeof(T))
+      return Fail();
+    values.resize(n);
+    fIn.read(reinterpret_cast<char*>(values.data()), n * sizeof(T));
+  }
+
+ private:
+  // guards against allocating a garbage size from a corrupt file
+  static constexpr std::uint64_t kMaxSize = std::uint64_t(1) << 36;
+  void Fail() { fIn.setstate(std::ios::failbit); }
+
+  std::istream& fIn;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Shard and run a state file belongs to, and where a run split into
+/// checkpointed segments stands (see Checkpoint); the progress fields are
+/// left at their defaults in the files of shards.
+struct RunProgress
+{
+  G4int fRunID = -1;  // run ID of the event seeds
+  G4int fShardIndex = 0;  // shard i of N (see Shard); N = 0 if not sharded
+  G4int fShardCount = 0;
+  G4int fNextRunID = 0;  // Geant4 run ID after the last segment
+  std::int64_t fEvents = 0;  // events of the whole run
+  std::int64_t fEventsDone = 0;
+  G4String fEngineState;  // master engine after the last segment
+};
+
+/// State file of a run: the merged Run counters, maps and moments, and the
+/// raw contents of the analysis-manager H1s (before the normalization
+/// made by Run::EndOfRun). Layout: magic "OPN2RUNS", uint32 version, the
+/// RunProgress fields, then the fields of Run::Save and of every H1.
+///
+/// Written by each shard of a multi-process run (see Shard) and read by
+/// OpNovice2Merge, which adds the runs with Run::Merge and the H1s bin by
+/// bin, then makes the end-of-run analysis once on the total. Also the
+/// checkpoint of a long run (see Checkpoint).
+
+class RunState
+{
+ public:
+  // written to FILE.tmp, synced and renamed, so that FILE is always
+  // complete, even after a crash
+  static G4bool Write(const G4String& fileName, const Run& run,
+                      const RunProgress& progress = RunProgress());
+  // run is overwritten; the H1s are added to those of the analysis manager
+  static G4bool Read(const G4String& fileName, Run& run,
+                     RunProgress* progress = nullptr);
+  // the progress only, without touching any run or histogram
+  static G4bool ReadProgress(const G4String& fileName, RunProgress& progress);
+
+ private:
+  static G4bool ReadHeader(StateReader& in, RunProgress& progress);
+  static void SaveHistograms(StateWriter& out);
+  static G4bool AddHistograms(StateReader& in);
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,119 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/ScintillationEmitter.cc
+/// \brief Implementation of the ScintillationEmitter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ScintillationEmitter.hh"
+
+#include "G4Event.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+ScintillationEmitter::ScintillationEmitter(const G4Material* material)
+{
+  G4MaterialPropertiesTable* mpt =
+    material ? material->GetMaterialPropertiesTable() : nullptr;
+  G4MaterialPropertyVector* spectrum =
+    mpt ? mpt->GetProperty(kSCINTILLATIONCOMPONENT1) : nullptr;
+  if(!spectrum || spectrum->GetVectorLength() < 2)
+  {
+    G4ExceptionDescription ed;
+    ed << "Material "
+       << (material ? material->GetName() : G4String("(none)"))
+       << " has no SCINTILLATIONCOMPONENT1 spectrum.";
+    G4Exception("ScintillationEmitter::ScintillationEmitter", "OpNovice2_016",
+                FatalException, ed);
+    return;
+  }
+  if(mpt->ConstPropertyExists(kSCINTILLATIONYIELD))
+    fYield = mpt->GetConstProperty(kSCINTILLATIONYIELD);
+  if(mpt->ConstPropertyExists(kSCINTILLATIONTIMECONSTANT1))
+    fTimeConstant = mpt->GetConstProperty(kSCINTILLATIONTIMECONSTANT1);
+  fBirksConstant = material->GetIonisation()->GetBirksConstant();
+
+  // trapezoidal integral of the tabulated spectrum
+  std::size_t n = spectrum->GetVectorLength();
+  fEnergy.resize(n);
+  fCdf.assign(n, 0.);
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    fEnergy[i] = spectrum->Energy(i);
+    if(i > 0)
+      fCdf[i] = fCdf[i - 1] + 0.5 * ((*spectrum)[i] + (*spectrum)[i - 1]) *
+                                (fEnergy[i] - fEnergy[i - 1]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double ScintillationEmitter::SampleEnergy() const
+{
+  // linear interpolation in the integral, like G4Scintillation
+  G4double r = G4UniformRand() * fCdf.back();
+  std::size_t i =
+    std::upper_bound(fCdf.begin(), fCdf.end(), r) - fCdf.begin();
+  i = std::min(std::max<std::size_t>(i, 1), fCdf.size() - 1);
+  G4double width = fCdf[i] - fCdf[i - 1];
+  G4double f     = width > 0. ? (r - fCdf[i - 1]) / width : 0.;
+  return fEnergy[i - 1] + f * (fEnergy[i] - fEnergy[i - 1]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void ScintillationEmitter::AddPhoton(G4Event* event,
+                                     const G4ThreeVector& position,
+                                     G4double time) const
+{
+  G4double cost = 1. - 2. * G4UniformRand();
+  G4double sint = std::sqrt((1. - cost) * (1. + cost));
+  G4double phi  = CLHEP::twopi * G4UniformRand();
+  G4ThreeVector direction(sint * std::cos(phi), sint * std::sin(phi), cost);
+
+  G4ThreeVector polarization = direction.orthogonal().unit();
+  polarization.rotate(CLHEP::twopi * G4UniformRand(), direction);
+
+  auto particle =
+    new G4PrimaryParticle(G4OpticalPhoton::OpticalPhotonDefinition());
+  particle->SetKineticEnergy(SampleEnergy());
+  particle->SetMomentumDirection(direction);
+  particle->SetPolarization(polarization);
+
+  auto vertex = new G4PrimaryVertex(position, time);
+  vertex->SetPrimary(particle);
+  event->AddPrimaryVertex(vertex);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,77 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/ScintillationEmitter.hh
+/// \brief Definition of the ScintillationEmitter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ScintillationEmitter_h
+#define ScintillationEmitter_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+class G4Event;
+class G4Material;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Emits scintillation photons of a material as primaries: energy from
+/// SCINTILLATIONCOMPONENT1 (sampled as in G4Scintillation), isotropic
+/// direction and a random linear polarization perpendicular to it.
+
+class ScintillationEmitter
+{
+ public:
+  explicit ScintillationEmitter(const G4Material* material);
+  ~ScintillationEmitter() = default;
+
+  G4bool IsValid() const { return !fCdf.empty(); }
+  // photons per unit energy, first time constant, Birks constant
+  G4double GetYield() const { return fYield; }
+  G4double GetTimeConstant() const { return fTimeConstant; }
+  G4double GetBirksConstant() const { return fBirksConstant; }
+
+  G4double SampleEnergy() const;
+  // one optical-photon vertex at the given position and time
+  void AddPhoton(G4Event* event, const G4ThreeVector& position,
+                 G4double time) const;
+
+ private:
+  G4double fYield = 0.;
+  G4double fTimeConstant = 0.;
+  G4double fBirksConstant = 0.;
+  std::vector<G4double> fEnergy;
+  std::vector<G4double> fCdf;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/Shard.cc
+/// \brief Implementation of the Shard class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Shard.hh"
+
+#include "EventSeeder.hh"
+
+#include "Randomize.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+Shard* Shard::Instance()
+{
+  static Shard instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool Shard::Parse(const G4String& spec)
+{
+  std::istringstream is(spec);
+  G4int index = -1;
+  G4int count = 0;
+  char slash  = 0;
+  is >> index >> slash >> count;
+  if(!is || slash != '/' || !is.eof() || count < 1 || index < 0 ||
+     index >= count)
+    return false;
+  fIndex = index;
+  fCount = count;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void Shard::BeginOfRun(G4int runID, G4long eventsPerShard, G4long firstEvent)
+{
+  fRunID  = runID;
+  fOffset = fIndex * eventsPerShard + firstEvent;
+  if(!IsActive())
+    return;
+
+  // all shards start from the same engine state: the key is common, the
+  // counter differs
+  auto key = std::array<std::uint32_t, 2>{
+    std::uint32_t(G4UniformRand() * 4294967296.),
+    std::uint32_t(G4UniformRand() * 4294967296.)
+  };
+  EventSeeder::SetSeeds(EventSeeder::Philox(
+    { std::uint32_t(fIndex), std::uint32_t(fCount), std::uint32_t(runID), 0 },
+    key));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4String Shard::FileName(const G4String& name) const
+{
+  std::ostringstream tag;
+  if(IsActive())
+    tag << "_shard" << fIndex << "of" << fCount;
+  if(fJob >= 0)
+    tag << "_job" << fJob;
+  return tag.str().empty() ? name : AddTag(name, tag.str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4String Shard::AddTag(const G4String& name, const G4String& tag)
+{
+  if(name.empty() || name.find(tag) != std::string::npos)
+    return name;
+
+  // before the extension, if any, of the last path component
+  std::size_t slash = name.find_last_of("/\\");
+  std::size_t dot   = name.find_last_of('.');
+  if(dot == std::string::npos || (slash != std::string::npos && dot < slash) ||
+     dot == (slash == std::string::npos ? 0 : slash + 1))
+    return name + tag;
+  return name.substr(0, dot) + tag + name.substr(dot);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4String Shard::StateFileName(G4int runID) const
+{
+  std::ostringstream name;
+  name << "opnovice2_run" << runID << ".state";
+  return FileName(name.str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,91 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/Shard.hh
+/// \brief Definition of the Shard class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Shard_h
+#define Shard_h 1
+
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Shard i of N of a run split over N processes (OpNovice2 --shard i/N).
+///
+/// Each process runs /run/beamOn M with the same macro; shard i takes the
+/// global events [i M, (i+1) M), used for the event seeds, quasi-random
+/// points and phase-space slices, and its master engine is reseeded from
+/// (i, N, run ID), so the shards never share random numbers. Output files
+/// get a _shard<i>of<N> suffix, and the merged run is saved at end of run
+/// to a RunState file, which OpNovice2Merge adds up. Job k of a sweep (see
+/// SweepServer) adds a _job<k> suffix, so that the jobs never write the
+/// same files.
+
+class Shard
+{
+ public:
+  static Shard* Instance();
+
+  // "i/N" with 0 <= i < N; false if malformed
+  G4bool Parse(const G4String& spec);
+  G4bool IsActive() const { return fCount > 0; }
+  G4int GetIndex() const { return fIndex; }
+  G4int GetCount() const { return fCount; }
+  // job of a sweep, -1 if none
+  void SetJob(G4int job) { fJob = job; }
+
+  // master thread, at begin of run, before the worker seeds are drawn;
+  // firstEvent > 0 for the later segments of a checkpointed run, whose
+  // run ID is that of its first segment (see Checkpoint)
+  void BeginOfRun(G4int runID, G4long eventsPerShard, G4long firstEvent = 0);
+  G4int GetRunID() const { return fRunID; }
+  G4long GetGlobalEventID(G4int eventID) const { return fOffset + eventID; }
+
+  // name.ext -> name_shard<i>of<N>_job<k>.ext; unchanged when neither
+  // sharded nor in a sweep job
+  G4String FileName(const G4String& name) const;
+  // run state of this shard, opnovice2_run<ID>_shard<i>of<N>.state
+  G4String StateFileName(G4int runID) const;
+  // name.ext -> name<tag>.ext, unless name already has the tag
+  static G4String AddTag(const G4String& name, const G4String& tag);
+
+ private:
+  Shard() = default;
+
+  G4int fIndex = 0;
+  G4int fCount = 0;
+  G4int fJob = -1;
+  G4int fRunID = 0;
+  G4long fOffset = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
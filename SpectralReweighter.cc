@@ -0,0 +1,239 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/SpectralReweighter.cc
+/// \brief Implementation of the SpectralReweighter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SpectralReweighter.hh"
+
+#include "XraySpectrum.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+const char kEventFileMagic[8] = { 'O', 'P', 'N', '2', 'E', 'V', 'T', '\0' };
+const std::uint32_t kEventFileVersion = 1;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+SpectralReweighter::SpectralReweighter(
+  std::shared_ptr<const XraySpectrum> reference)
+  : fReference(std::move(reference))
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+SpectralReweighter::Result SpectralReweighter::Reweight(
+  const std::vector<EventRecord>& records, const XraySpectrum& target) const
+{
+  Result result;
+  result.fTarget = target.GetName();
+  result.fOutsideReference =
+    target.GetMinEnergy() < fReference->GetMinEnergy() ||
+    target.GetMaxEnergy() > fReference->GetMaxEnergy();
+
+  std::vector<G4double> weights(records.size(), 0.);
+  G4double sumW        = 0.;
+  G4double sumW2       = 0.;
+  G4double sumDetected = 0.;
+  G4double sumEdep     = 0.;
+  G4double sumScint    = 0.;
+  for(std::size_t i = 0; i < records.size(); ++i)
+  {
+    const auto& rec = records[i];
+    G4double pRef   = fReference->Density(rec.fEnergy);
+    if(pRef <= 0.)
+      continue;
+    G4double w = target.Density(rec.fEnergy) / pRef;
+    weights[i] = w;
+    sumW += w;
+    sumW2 += w * w;
+    sumDetected += w * rec.fDetected;
+    sumEdep += w * rec.fEdep;
+    sumScint += w * rec.fScintillation;
+  }
+  if(sumW <= 0.)
+    return result;
+
+  result.fEffectiveEvents = sumW * sumW / sumW2;
+  result.fDetected        = sumDetected / sumW;
+  result.fEdep            = sumEdep / sumW;
+  result.fCollection      = sumScint > 0. ? sumDetected / sumScint : 0.;
+
+  // error of the self-normalized estimator
+  G4double varDetected = 0.;
+  G4double varEdep     = 0.;
+  for(std::size_t i = 0; i < records.size(); ++i)
+  {
+    G4double w  = weights[i];
+    G4double dn = records[i].fDetected - result.fDetected;
+    G4double de = records[i].fEdep - result.fEdep;
+    varDetected += w * w * dn * dn;
+    varEdep += w * w * de * de;
+  }
+  result.fDetectedError = std::sqrt(varDetected) / sumW;
+  result.fEdepError     = std::sqrt(varEdep) / sumW;
+  return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void SpectralReweighter::Print(const std::vector<Result>& results)
+{
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec              = G4cout.precision(4);
+
+  G4cout << "\n    Spectral reweighting\n";
+  G4cout << "---------------------------------\n";
+  for(const auto& res : results)
+  {
+    G4cout << "Target spectrum: " << res.fTarget << G4endl;
+    if(res.fOutsideReference)
+    {
+      G4cout << "  WARNING: target extends beyond the reference spectrum; "
+             << "that part is not covered." << G4endl;
+    }
+    G4cout << "  Effective events:           " << res.fEffectiveEvents
+           << G4endl;
+    G4cout << "  Detected photons / primary: " << res.fDetected << " +/- "
+           << res.fDetectedError << G4endl;
+    G4cout << "  Deposited energy / primary: " << res.fEdep / keV << " +/- "
+           << res.fEdepError / keV << " keV" << G4endl;
+    G4cout << "  Light collection efficiency: " << res.fCollection << G4endl;
+  }
+  G4cout << "---------------------------------" << G4endl;
+
+  G4cout.setf(mode, std::ios::floatfield);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool SpectralReweighter::WriteEvents(const G4String& fileName,
+                                       const XraySpectrum& reference,
+                                       const std::vector<EventRecord>& records)
+{
+  std::ofstream out(fileName, std::ios::binary);
+  if(!out)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot write event file " << fileName;
+    G4Exception("SpectralReweighter::WriteEvents", "OpNovice2_007",
+                JustWarning, ed);
+    return false;
+  }
+
+  std::uint32_t recordSize = sizeof(EventRecord);
+  std::uint64_t nRef       = reference.GetEnergies().size();
+  std::uint64_t nEvents    = records.size();
+  out.write(kEventFileMagic, sizeof(kEventFileMagic));
+  out.write(reinterpret_cast<const char*>(&kEventFileVersion),
+            sizeof(kEventFileVersion));
+  out.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+  out.write(reinterpret_cast<const char*>(&nRef), sizeof(nRef));
+  out.write(reinterpret_cast<const char*>(reference.GetEnergies().data()),
+            nRef * sizeof(G4double));
+  out.write(reinterpret_cast<const char*>(reference.GetFluences().data()),
+            nRef * sizeof(G4double));
+  out.write(reinterpret_cast<const char*>(&nEvents), sizeof(nEvents));
+  out.write(reinterpret_cast<const char*>(records.data()),
+            nEvents * sizeof(EventRecord));
+
+  G4cout << "Wrote " << nEvents << " event records to " << fileName
+         << G4endl;
+  return bool(out);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::shared_ptr<const XraySpectrum> SpectralReweighter::ReadEvents(
+  const G4String& fileName, std::vector<EventRecord>& records)
+{
+  std::ifstream in(fileName, std::ios::binary | std::ios::ate);
+  std::uint64_t fileSize = in ? std::uint64_t(in.tellg()) : 0;
+  in.seekg(0);
+  char magic[8]               = {};
+  std::uint32_t version       = 0;
+  std::uint32_t recordSize    = 0;
+  std::uint64_t nRef          = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(&version), sizeof(version));
+  in.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+  in.read(reinterpret_cast<char*>(&nRef), sizeof(nRef));
+  if(!in || std::memcmp(magic, kEventFileMagic, sizeof(magic)) != 0 ||
+     version != kEventFileVersion || recordSize != sizeof(EventRecord))
+  {
+    G4ExceptionDescription ed;
+    ed << fileName << " is not a compatible event file.";
+    G4Exception("SpectralReweighter::ReadEvents", "OpNovice2_008",
+                JustWarning, ed);
+    return nullptr;
+  }
+
+  // the counts are checked against the bytes left before allocating, so
+  // that a corrupt file cannot ask for a huge vector
+  auto remaining = [&in, fileSize]() {
+    return in ? fileSize - std::uint64_t(in.tellg()) : 0;
+  };
+  std::vector<G4double> energies;
+  std::vector<G4double> fluences;
+  std::uint64_t nEvents = 0;
+  G4bool sizesOK = nRef <= remaining() / (2 * sizeof(G4double));
+  if(sizesOK)
+  {
+    energies.resize(nRef);
+    fluences.resize(nRef);
+    in.read(reinterpret_cast<char*>(energies.data()),
+            nRef * sizeof(G4double));
+    in.read(reinterpret_cast<char*>(fluences.data()),
+            nRef * sizeof(G4double));
+    in.read(reinterpret_cast<char*>(&nEvents), sizeof(nEvents));
+    sizesOK = nEvents <= remaining() / sizeof(EventRecord);
+  }
+  if(sizesOK)
+  {
+    records.resize(nEvents);
+    in.read(reinterpret_cast<char*>(records.data()),
+            nEvents * sizeof(EventRecord));
+  }
+  if(!sizesOK || !in)
+  {
+    G4ExceptionDescription ed;
+    ed << "Event file " << fileName << " is truncated or corrupt.";
+    G4Exception("SpectralReweighter::ReadEvents", "OpNovice2_008",
+                JustWarning, ed);
+    records.clear();
+    return nullptr;
+  }
+  return std::make_shared<XraySpectrum>(energies, fluences);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
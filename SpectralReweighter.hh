@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/SpectralReweighter.hh
+/// \brief Definition of the SpectralReweighter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SpectralReweighter_h
+#define SpectralReweighter_h 1
+
+#include "EventAction.hh"
+#include "globals.hh"
+
+#include <memory>
+#include <vector>
+
+class XraySpectrum;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Post-hoc reweighting of a run to another primary spectrum.
+///
+/// Events are simulated once with energies drawn from a broad reference
+/// spectrum p_ref(E). The response to any target spectrum p(E) is then the
+/// weighted sum over the stored events with w = p(E) / p_ref(E). Results are
+/// self-normalized; the effective number of events (sum w)^2 / sum w^2 tells
+/// how much statistics survive the reweighting.
+///
+/// The event file keeps the reference table next to the records, so a later
+/// session can reweight it without re-simulating.
+
+class SpectralReweighter
+{
+ public:
+  struct Result
+  {
+    G4String fTarget;
+    G4double fEffectiveEvents = 0.;
+    G4double fDetected = 0.;  // mean detected photons per primary
+    G4double fDetectedError = 0.;
+    G4double fEdep = 0.;  // mean deposited energy per primary
+    G4double fEdepError = 0.;
+    G4double fCollection = 0.;  // detected / created scintillation photons
+    G4bool fOutsideReference = false;
+  };
+
+  explicit SpectralReweighter(std::shared_ptr<const XraySpectrum> reference);
+  ~SpectralReweighter() = default;
+
+  Result Reweight(const std::vector<EventRecord>& records,
+                  const XraySpectrum& target) const;
+
+  static void Print(const std::vector<Result>& results);
+
+  static G4bool WriteEvents(const G4String& fileName,
+                            const XraySpectrum& reference,
+                            const std::vector<EventRecord>& records);
+  // returns the reference spectrum stored in the file, null on failure
+  static std::shared_ptr<const XraySpectrum> ReadEvents(
+    const G4String& fileName, std::vector<EventRecord>& records);
+
+ private:
+  std::shared_ptr<const XraySpectrum> fReference;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,214 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/SpreadFunction.cc
+/// \brief Implementation of the SpreadFunction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SpreadFunction.hh"
+
+#include "Histo2D.hh"
+
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+// first position where the falling curve y(x) crosses the level
+G4double Crossing(const std::vector<G4double>& x,
+                  const std::vector<G4double>& y, G4double level)
+{
+  for(std::size_t i = 1; i < y.size(); ++i)
+  {
+    if(y[i - 1] >= level && y[i] < level)
+      return x[i - 1] +
+             (x[i] - x[i - 1]) * (y[i - 1] - level) / (y[i - 1] - y[i]);
+  }
+  return 0.;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+SpreadFunction::SpreadFunction(const Histo2D& psf)
+{
+  fEntries = psf.GetSum();
+  std::vector<G4double> lsfX(psf.GetNx(), 0.);
+  std::vector<G4double> lsfY(psf.GetNy(), 0.);
+  for(G4int j = 0; j < psf.GetNy(); ++j)
+  {
+    for(G4int i = 0; i < psf.GetNx(); ++i)
+    {
+      lsfX[i] += psf.GetBinContent(i, j);
+      lsfY[j] += psf.GetBinContent(i, j);
+    }
+  }
+  Analyze(fX, lsfX, psf.GetXmin(), psf.GetBinWidthX());
+  Analyze(fY, lsfY, psf.GetYmin(), psf.GetBinWidthY());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void SpreadFunction::FFT(std::vector<std::complex<G4double>>& a)
+{
+  // iterative radix-2 Cooley-Tukey
+  std::size_t n = a.size();
+  for(std::size_t i = 1, j = 0; i < n; ++i)
+  {
+    std::size_t bit = n >> 1;
+    for(; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if(i < j)
+      std::swap(a[i], a[j]);
+  }
+  for(std::size_t len = 2; len <= n; len <<= 1)
+  {
+    G4double angle = -twopi / len;
+    std::complex<G4double> wlen(std::cos(angle), std::sin(angle));
+    for(std::size_t i = 0; i < n; i += len)
+    {
+      std::complex<G4double> w(1.);
+      for(std::size_t k = 0; k < len / 2; ++k)
+      {
+        auto u             = a[i + k];
+        auto v             = a[i + k + len / 2] * w;
+        a[i + k]           = u + v;
+        a[i + k + len / 2] = u - v;
+        w *= wlen;
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void SpreadFunction::Analyze(Axis& axis, const std::vector<G4double>& lsf,
+                             G4double min, G4double width)
+{
+  G4double sum  = 0.;
+  G4double peak = 0.;
+  for(auto v : lsf)
+  {
+    sum += v;
+    peak = std::max(peak, v);
+  }
+  std::size_t n = lsf.size();
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    axis.fPosition.push_back(min + (i + 0.5) * width);
+    axis.fLSF.push_back(sum > 0. ? lsf[i] / (sum * width) : 0.);
+  }
+  if(sum <= 0.)
+    return;
+
+  // FWHM between the outermost half-maximum crossings
+  std::size_t first = 0;
+  std::size_t last  = n - 1;
+  while(lsf[first] < 0.5 * peak)
+    ++first;
+  while(lsf[last] < 0.5 * peak)
+    --last;
+  auto edge = [&](std::size_t i, std::size_t j) {
+    // interpolated position of the half maximum between bins i and j
+    G4double f = (0.5 * peak - lsf[i]) / (lsf[j] - lsf[i]);
+    return axis.fPosition[i] + f * (axis.fPosition[j] - axis.fPosition[i]);
+  };
+  G4double left  = first > 0 ? edge(first - 1, first) : axis.fPosition[0];
+  G4double right = last < n - 1 ? edge(last + 1, last) : axis.fPosition[n - 1];
+  axis.fFWHM     = right - left;
+
+  // zero-padded to twice the next power of two against wrap-around
+  std::size_t size = 1;
+  while(size < 2 * n)
+    size <<= 1;
+  std::vector<std::complex<G4double>> data(size);
+  for(std::size_t i = 0; i < n; ++i)
+    data[i] = lsf[i];
+  FFT(data);
+
+  G4double dc = std::abs(data[0]);
+  for(std::size_t k = 0; k <= size / 2; ++k)
+  {
+    axis.fFrequency.push_back(k / (size * width));
+    axis.fMTF.push_back(std::abs(data[k]) / dc);
+  }
+  axis.fMTF50 = Crossing(axis.fFrequency, axis.fMTF, 0.5);
+  axis.fMTF10 = Crossing(axis.fFrequency, axis.fMTF, 0.1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void SpreadFunction::Print() const
+{
+  G4cout << "\n-------- Spread function (" << fEntries
+         << " detected photons) --------" << G4endl;
+  G4cout << "LSF FWHM x, y [um]:   " << fX.fFWHM * 1000. << "  "
+         << fY.fFWHM * 1000. << G4endl;
+  G4cout << "MTF50 x, y [lp/mm]:   " << fX.fMTF50 << "  " << fY.fMTF50
+         << G4endl;
+  G4cout << "MTF10 x, y [lp/mm]:   " << fX.fMTF10 << "  " << fY.fMTF10
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void SpreadFunction::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if(!out)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open " << fileName << " for writing.";
+    G4Exception("SpreadFunction::Write", "OpNovice2_013", JustWarning, ed);
+    return;
+  }
+  out << "# entries " << fEntries << "\n"
+      << "# fwhm_x_mm " << fX.fFWHM << "\n"
+      << "# fwhm_y_mm " << fY.fFWHM << "\n"
+      << "# mtf50_x_lpmm " << fX.fMTF50 << "\n"
+      << "# mtf50_y_lpmm " << fY.fMTF50 << "\n"
+      << "# mtf10_x_lpmm " << fX.fMTF10 << "\n"
+      << "# mtf10_y_lpmm " << fY.fMTF10 << "\n"
+      << "# x_mm lsf_x y_mm lsf_y f_lpmm mtf_x mtf_y\n";
+  out << std::setprecision(6);
+  std::size_t rows = std::max({ fX.fPosition.size(), fY.fPosition.size(),
+                                fX.fFrequency.size() });
+  for(std::size_t i = 0; i < rows; ++i)
+  {
+    // columns run out at different rows; missing values are written as nan
+    auto value = [i](const std::vector<G4double>& v) {
+      return i < v.size() ? v[i] : std::nan("");
+    };
+    out << value(fX.fPosition) << " " << value(fX.fLSF) << " "
+        << value(fY.fPosition) << " " << value(fY.fLSF) << " "
+        << value(fX.fFrequency) << " " << value(fX.fMTF) << " "
+        << value(fY.fMTF) << "\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/SpreadFunction.hh
+/// \brief Definition of the SpreadFunction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SpreadFunction_h
+#define SpreadFunction_h 1
+
+#include "globals.hh"
+
+#include <complex>
+#include <vector>
+
+class Histo2D;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Resolution metrics from the point spread function, i.e. the map of
+/// detected photon positions relative to the entrance point of their
+/// primary. The line spread functions are its projections on x and y; the
+/// MTF is the modulus of their Fourier transform, normalized at zero
+/// frequency. Lengths in mm, frequencies in line pairs per mm.
+
+class SpreadFunction
+{
+ public:
+  explicit SpreadFunction(const Histo2D& psf);
+  ~SpreadFunction() = default;
+
+  void Print() const;
+  // table of position, LSF x/y, frequency, MTF x/y, with a summary header
+  void Write(const G4String& fileName) const;
+
+  // in place, size a power of two
+  static void FFT(std::vector<std::complex<G4double>>& data);
+
+ private:
+  struct Axis
+  {
+    std::vector<G4double> fPosition;
+    std::vector<G4double> fLSF;  // normalized to unit area
+    std::vector<G4double> fFrequency;
+    std::vector<G4double> fMTF;
+    G4double fFWHM = 0.;
+    G4double fMTF50 = 0.;  // frequency where the MTF drops to 0.5
+    G4double fMTF10 = 0.;
+  };
+
+  static void Analyze(Axis& axis, const std::vector<G4double>& lsf,
+                      G4double min, G4double width);
+
+  Axis fX;
+  Axis fY;
+  G4double fEntries = 0.;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,187 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/StepProfile.cc
+/// \brief Implementation of the StepProfile class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StepProfile.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+std::int64_t Nanoseconds(std::chrono::steady_clock::duration d)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void StepProfile::BeginStep(const G4Step* step)
+{
+  fEnter               = Clock::now();
+  std::int64_t gap     = fStarted ? Nanoseconds(fEnter - fLastExit) : 0;
+  const G4Track* track = step->GetTrack();
+
+  // the first step of an event also waited for the primaries
+  if(track->GetTrackID() == 1 && track->GetCurrentStepNumber() == 1)
+  {
+    fEventGap.fSteps += 1;
+    fEventGap.fTime += gap;
+    return;
+  }
+  Key key{ track->GetDefinition(),
+           step->GetPostStepPoint()->GetProcessDefinedStep(),
+           step->GetPreStepPoint()->GetPhysicalVolume() };
+  Entry& entry = fEntries[key];
+  entry.fSteps += 1;
+  entry.fTime += gap;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void StepProfile::EndStep()
+{
+  fLastExit = Clock::now();
+  fStarted  = true;
+  fUser.fSteps += 1;
+  fUser.fTime += Nanoseconds(fLastExit - fEnter);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+StepProfile::Names StepProfile::GetNames(const Key& key)
+{
+  return { key.fParticle ? key.fParticle->GetParticleName() : "none",
+           key.fProcess ? key.fProcess->GetProcessName() : "none",
+           key.fVolume ? key.fVolume->GetName() : "none" };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::vector<StepProfile::Row> StepProfile::Collect() const
+{
+  // processes are per thread, so pointers only identify rows of one table
+  auto rows = fMerged;
+  auto add  = [&rows](const Names& names, const Entry& entry) {
+    Entry& row = rows[names];
+    row.fSteps += entry.fSteps;
+    row.fTime += entry.fTime;
+  };
+  for(const auto& entry : fEntries)
+    add(GetNames(entry.first), entry.second);
+  if(fUser.fSteps > 0)
+    add({ "(user)", "SteppingAction", "-" }, fUser);
+  if(fEventGap.fSteps > 0)
+    add({ "(event)", "between events", "-" }, fEventGap);
+
+  std::vector<Row> sorted(rows.begin(), rows.end());
+  std::sort(sorted.begin(), sorted.end(), [](const Row& a, const Row& b) {
+    return a.second.fTime > b.second.fTime;
+  });
+  return sorted;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void StepProfile::Add(const StepProfile& other)
+{
+  for(const auto& row : other.Collect())
+  {
+    Entry& entry = fMerged[row.first];
+    entry.fSteps += row.second.fSteps;
+    entry.fTime += row.second.fTime;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void StepProfile::Print(std::size_t n) const
+{
+  auto sorted = Collect();
+  if(sorted.empty())
+    return;
+
+  G4double total = 0.;
+  for(const auto& row : sorted)
+    total += row.second.fTime;
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec              = G4cout.precision(3);
+
+  G4cout << "\n-------- Step profile (" << total * 1.e-9
+         << " s over all threads) --------" << G4endl;
+  G4cout << std::left << std::setw(16) << "particle" << std::setw(20)
+         << "process" << std::setw(14) << "volume" << std::right
+         << std::setw(14) << "steps" << std::setw(11) << "time [s]"
+         << std::setw(11) << "ns/step" << std::setw(8) << "%" << G4endl;
+  for(std::size_t i = 0; i < std::min(n, sorted.size()); ++i)
+  {
+    const Names& names = sorted[i].first;
+    const Entry& entry = sorted[i].second;
+    G4cout << std::left << std::setw(16) << names[0] << std::setw(20)
+           << names[1] << std::setw(14) << names[2] << std::right
+           << std::setw(14) << entry.fSteps << std::setw(11)
+           << entry.fTime * 1.e-9 << std::setw(11)
+           << G4double(entry.fTime) / std::max<std::uint64_t>(entry.fSteps, 1)
+           << std::setw(8) << 100. * entry.fTime / total << G4endl;
+  }
+  if(sorted.size() > n)
+    G4cout << "(" << sorted.size() - n << " more rows)" << G4endl;
+
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void StepProfile::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if(!out)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open " << fileName << " for writing.";
+    G4Exception("StepProfile::Write", "OpNovice2_013", JustWarning, ed);
+    return;
+  }
+  out << "# particle process volume steps time_ns\n";
+  for(const auto& row : Collect())
+  {
+    // names may contain blanks
+    out << std::quoted(std::string(row.first[0])) << " "
+        << std::quoted(std::string(row.first[1])) << " "
+        << std::quoted(std::string(row.first[2])) << " "
+        << row.second.fSteps << " " << row.second.fTime << "\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
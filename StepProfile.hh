@@ -0,0 +1,146 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/StepProfile.hh
+/// \brief Definition of the StepProfile class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StepProfile_h
+#define StepProfile_h 1
+
+#include "globals.hh"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Step;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Steps and wall time per (particle, process defining the step, volume),
+/// enabled with /opnovice2/profile/enable.
+///
+/// The time of a step is the time since the user stepping action of the
+/// previous step returned on the same thread, so it contains the Geant4
+/// work for the step (and, for the first step of a track, the stacking and
+/// tracking overhead). The time spent in SteppingAction itself is a row of
+/// its own, as is the gap at event boundaries (primary generation, end of
+/// event). Each thread fills its own table in its Run, keyed by pointers;
+/// tables are merged by names in Run::Merge.
+
+class StepProfile
+{
+ public:
+  StepProfile() = default;
+  ~StepProfile() = default;
+
+  // around the body of the user stepping action
+  void BeginStep(const G4Step* step);
+  void EndStep();
+
+  void Add(const StepProfile& other);
+
+  // the rows sorted by time, the first n printed or all written
+  void Print(std::size_t n) const;
+  void Write(const G4String& fileName) const;
+
+  /// Times the enclosing scope if profile is not null.
+  class Scope
+  {
+   public:
+    Scope(StepProfile* profile, const G4Step* step) : fProfile(profile)
+    {
+      if(fProfile)
+        fProfile->BeginStep(step);
+    }
+    ~Scope()
+    {
+      if(fProfile)
+        fProfile->EndStep();
+    }
+
+   private:
+    StepProfile* fProfile;
+  };
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  using Names = std::array<G4String, 3>;
+
+  struct Key
+  {
+    const G4ParticleDefinition* fParticle;
+    const G4VProcess* fProcess;
+    const G4VPhysicalVolume* fVolume;
+    G4bool operator==(const Key& other) const
+    {
+      return fParticle == other.fParticle && fProcess == other.fProcess &&
+             fVolume == other.fVolume;
+    }
+  };
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const
+    {
+      std::hash<const void*> h;
+      return h(key.fParticle) ^ (h(key.fProcess) << 1) ^ (h(key.fVolume) << 2);
+    }
+  };
+  struct Entry
+  {
+    std::uint64_t fSteps = 0;
+    std::int64_t fTime = 0;  // ns
+  };
+
+  using Row = std::pair<Names, Entry>;
+
+  static Names GetNames(const Key& key);
+  // all rows, this thread's and merged ones, by decreasing time
+  std::vector<Row> Collect() const;
+
+  std::unordered_map<Key, Entry, KeyHash> fEntries;  // this thread
+  std::map<Names, Entry> fMerged;  // other threads
+  Entry fUser;
+  Entry fEventGap;
+
+  Clock::time_point fEnter;
+  Clock::time_point fLastExit;
+  G4bool fStarted = false;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -2,19 +2,69 @@
 #include "Run.hh"
 #include "RunAction.hh"
 #include "DetectorConstruction.hh"
+#include "DepositFile.hh"
+#include "EventAction.hh"
+#include "PhotonHitStream.hh"
+#include "ProgressMonitor.hh"
+#include "Shard.hh"
+#include "StepProfile.hh"
 #include "SteppingMessenger.hh"
+#include "TrackInformation.hh"
 #include "G4OpticalPhoton.hh"
 #include "G4OpBoundaryProcess.hh"
+#include "G4ProcessManager.hh"
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4Event.hh"
+#include "G4EmSaturation.hh"
+#include "G4LossTableManager.hh"
+#include "Randomize.hh"
 #include <set>  // For tracking unique photons
 
-long gTotalScint = 0;
-long gEscape = 0;
-extern long gDetectedPhotons;  // DECLARE EXTERNAL COUNTER
+namespace
+{
+// boundary statuses that send the photon back into the volume it came from
+G4bool IsReflection(G4OpBoundaryProcessStatus status)
+{
+    switch (status)
+    {
+        case FresnelReflection:
+        case TotalInternalReflection:
+        case LambertianReflection:
+        case LobeReflection:
+        case SpikeReflection:
+        case BackScattering:
+        case CoatedDielectricReflection:
+            return true;
+        default:
+            // look-up-table surfaces: Polished/Etched/Ground...Reflection
+            return status >= PolishedLumirrorAirReflection &&
+                   status <= GroundVM2000GlueReflection;
+    }
+}
 
-SteppingAction::SteppingAction(RunAction* run, const DetectorConstruction* det)
-    : G4UserSteppingAction(), fRunAction(run), fDetConstruction(det)
+// status of the last step of this thread's G4OpBoundaryProcess, which is
+// a forced post-step process: the step is limited by Transportation
+G4OpBoundaryProcessStatus GetBoundaryStatus(const G4Track* track)
+{
+    static G4ThreadLocal G4OpBoundaryProcess* boundary = nullptr;
+    if (!boundary) {
+        auto processes =
+            track->GetDefinition()->GetProcessManager()->GetProcessList();
+        for (std::size_t i = 0; i < processes->size() && !boundary; ++i)
+            boundary = dynamic_cast<G4OpBoundaryProcess*>((*processes)[i]);
+    }
+    return boundary ? boundary->GetStatus() : Undefined;
+}
+}
+
+SteppingAction::SteppingAction(RunAction* run, const DetectorConstruction* det,
+                               EventAction* event)
+    : G4UserSteppingAction(), fRunAction(run), fDetConstruction(det),
+      fEventAction(event)
 {
     fSteppingMessenger = new SteppingMessenger(this);
 }
@@ -32,6 +82,7 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
 
     Run* run = static_cast<Run*>(
         G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    StepProfile::Scope profile(run->GetStepProfile(), step);
 
     //------------------------------------------------------
     // Optical photon handling
@@ -40,17 +91,81 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
     {
         auto prePV = pre->GetPhysicalVolume();
         auto postPV = post->GetPhysicalVolume();
+        G4bool firstStep = track->GetCurrentStepNumber() == 1;
+        run->AddOpticalStep(firstStep);
+        if (firstStep) ProgressMonitor::AddPhoton();
+
+        // path length in the CsI, for absorption-length reweighting
+        if (prePV && prePV->GetName() == "Tank")
+        {
+            if (auto info = static_cast<TrackInformation*>(
+                    track->GetUserInformation()))
+                info->AddTankPathLength(step->GetStepLength());
+        }
 
         // SIMPLE APPROACH: Just detect when photon enters photodiode from Tank
         if (post->GetStepStatus() == fGeomBoundary && prePV && postPV)
         {
             // When photon crosses from Tank to Photodiode, COUNT IT!
-            if (prePV->GetName() == "Tank" && postPV->GetName() == "Photodiode")
+            // Photons reflected by the photodiode face (tabulated
+            // REFLECTIVITY, not /opnovice2/pdPerfectAbsorber) stay in the
+            // CsI and are no arrivals.
+            if (prePV->GetName() == "Tank" &&
+                postPV->GetName() == "Photodiode" &&
+                !IsReflection(GetBoundaryStatus(track)))
             {
                 // COUNT AS DETECTED - use BOTH counters
                 fRunAction->AddPhotonToExitCount();
                 run->AddDetectedPD();
-                gDetectedPhotons++;  // INCREMENT GLOBAL COUNTER
+                auto info = static_cast<TrackInformation*>(
+                    track->GetUserInformation());
+                fEventAction->AddDetected(info ? info->GetPrimaryIndex() : 0);
+
+                const G4VTouchable* touch = post->GetTouchable();
+                G4ThreeVector local = touch->GetHistory()
+                    ->GetTopTransform().TransformPoint(post->GetPosition());
+                run->FillPDHit(local.x(), local.y());
+                run->FillArrival(h_Planck * c_light / track->GetKineticEnergy());
+                if (run->GetOpticalReweighter().IsActive())
+                {
+                    DetectedPhoton photon;
+                    photon.fWrapReflections =
+                        info ? info->GetWrapReflectionNumber() : 0;
+                    photon.fPathLength = info ? info->GetTankPathLength() : 0.;
+                    photon.fEnergy = track->GetKineticEnergy();
+                    run->GetOpticalReweighter().AddPhoton(photon);
+                }
+                run->AddResponseDetected(track->GetVertexPosition(),
+                                         post->GetGlobalTime());
+                // point spread: displacement from the primary's entrance
+                if (auto entrance = fEventAction->GetEntrance(
+                        info ? info->GetPrimaryIndex() : 0))
+                {
+                    run->FillSpread(post->GetPosition().x() - entrance->x(),
+                                    post->GetPosition().y() - entrance->y());
+                }
+
+                auto hits = PhotonHitStream::Instance();
+                if (hits->IsOpen())
+                {
+                    const G4ThreeVector& vertex = track->GetVertexPosition();
+                    PhotonHit hit;
+                    // global over shards and checkpoint segments
+                    hit.fEventID = G4int(Shard::Instance()->GetGlobalEventID(
+                        G4RunManager::GetRunManager()
+                            ->GetCurrentEvent()->GetEventID()));
+                    hit.fPixel = touch->GetCopyNumber();
+                    hit.fX = float(local.x() / mm);
+                    hit.fY = float(local.y() / mm);
+                    hit.fTime = float(post->GetGlobalTime() / ns);
+                    hit.fWavelength = float(
+                        h_Planck * c_light / track->GetKineticEnergy() / nm);
+                    hit.fEmission[0] = float(vertex.x() / mm);
+                    hit.fEmission[1] = float(vertex.y() / mm);
+                    hit.fEmission[2] = float(vertex.z() / mm);
+                    hit.fReflections = info ? info->GetReflectionNumber() : 0;
+                    hits->Push(hit);
+                }
                 
                 G4double energy = track->GetKineticEnergy();
                 run->AddScintEnergy(energy);
@@ -67,16 +182,23 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
                 return;
             }
             
-            // Track all boundary events for statistics
-            const G4VProcess* proc = post->GetProcessDefinedStep();
-            if (proc && proc->GetProcessName() == "OpBoundary")
+            // Track all boundary events for statistics; the step is
+            // defined by Transportation, the status is the boundary
+            // process's
+            G4OpBoundaryProcessStatus status = GetBoundaryStatus(track);
+            if (status != Undefined)
             {
-                const G4OpBoundaryProcess* bp = 
-                    dynamic_cast<const G4OpBoundaryProcess*>(proc);
-                if (bp)
+                run->AddTotalSurface();
+                run->CountBoundaryStatus(status);
+                auto info = static_cast<TrackInformation*>(
+                    track->GetUserInformation());
+                if (info && IsReflection(status))
                 {
-                    run->AddTotalSurface();
-                    run->CountBoundaryStatus(bp->GetStatus());
+                    info->IncrementReflectionNumber();
+                    // Tank to World goes through the ReflectiveWrap skin
+                    if (prePV->GetName() == "Tank" &&
+                        postPV->GetName() == "World")
+                        info->IncrementWrapReflectionNumber();
                 }
             }
             
@@ -97,7 +219,6 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
                         // First time this photon exits +Z face
                         countedPhotons.insert(trackID);
                         run->AddExitPlusZ();
-                        gEscape++;
                     }
                 }
             }
@@ -128,6 +249,56 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
     //------------------------------------------------------
     else
     {
+        // primary entering the scintillator
+        if (track->GetParentID() == 0 &&
+            post->GetStepStatus() == fGeomBoundary &&
+            post->GetPhysicalVolume() &&
+            post->GetPhysicalVolume()->GetName() == "Tank")
+        {
+            run->FillEntrance(post->GetPosition().x(),
+                              post->GetPosition().y());
+            auto info = static_cast<TrackInformation*>(
+                track->GetUserInformation());
+            fEventAction->SetEntrance(info ? info->GetPrimaryIndex() : 0,
+                                      post->GetPosition());
+        }
+
+        if (pre->GetPhysicalVolume() &&
+            pre->GetPhysicalVolume()->GetName() == "Tank")
+        {
+            fEventAction->AddEdep(step->GetTotalEnergyDeposit());
+            if (step->GetTotalEnergyDeposit() > 0.)
+            {
+                fEventAction->SetFirstDepth(post->GetPosition().z() +
+                                            fDetConstruction->GetTankZ());
+
+                auto deposits = DepositStream::Instance();
+                if (deposits->IsOpen())
+                {
+                    G4ThreeVector mid =
+                        0.5 * (pre->GetPosition() + post->GetPosition());
+                    EnergyDeposit deposit;
+                    deposit.fEventID = G4int(
+                        Shard::Instance()->GetGlobalEventID(
+                            G4RunManager::GetRunManager()
+                                ->GetCurrentEvent()->GetEventID()));
+                    deposit.fPosition[0] = float(mid.x() / mm);
+                    deposit.fPosition[1] = float(mid.y() / mm);
+                    deposit.fPosition[2] = float(mid.z() / mm);
+                    deposit.fTime = float(
+                        0.5 * (pre->GetGlobalTime() + post->GetGlobalTime())
+                        / ns);
+                    deposit.fEdep =
+                        float(step->GetTotalEnergyDeposit() / keV);
+                    // Birks' law with the constant of the CsI material
+                    deposit.fVisible = float(
+                        G4LossTableManager::Instance()->EmSaturation()
+                            ->VisibleEnergyDepositionAtAStep(step) / keV);
+                    deposits->Add(deposit);
+                }
+            }
+        }
+
         const std::vector<const G4Track*>* secondaries = 
             step->GetSecondaryInCurrentStep();
         
@@ -144,7 +315,29 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
                         G4double photonE = sec->GetKineticEnergy();
                         run->AddScintillation();
                         run->AddScintEnergy(photonE);
-                        gTotalScint++;
+                        fEventAction->AddScintillation();
+
+                        // optical photons are killed at stacking; fold
+                        // with the tabulated collection probability
+                        if (auto model = run->GetResponseModel())
+                        {
+                            G4int voxel = model->Voxel(sec->GetPosition());
+                            G4double p =
+                                voxel < 0 ? 0. : model->Probability(voxel);
+                            run->AddFolded(p);
+                            if (G4UniformRand() < p)
+                            {
+                                auto info = static_cast<TrackInformation*>(
+                                    track->GetUserInformation());
+                                fRunAction->AddPhotonToExitCount();
+                                run->AddDetectedPD();
+                                run->AddFoldedDetected(
+                                    sec->GetGlobalTime() +
+                                    model->SampleTime(voxel));
+                                fEventAction->AddDetected(
+                                    info ? info->GetPrimaryIndex() : 0);
+                            }
+                        }
                     }
                 }
             }
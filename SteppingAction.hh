@@ -7,14 +7,13 @@
 class SteppingMessenger;
 class RunAction;
 class DetectorConstruction;
-
-extern long gTotalScint;
-extern long gEscape;
+class EventAction;
 
 class SteppingAction : public G4UserSteppingAction
 {
 public:
-    SteppingAction(RunAction* runAction, const DetectorConstruction* det);
+    SteppingAction(RunAction* runAction, const DetectorConstruction* det,
+                   EventAction* eventAction);
     ~SteppingAction() override;
 
     void UserSteppingAction(const G4Step* step) override;
@@ -32,6 +31,7 @@ private:
 
     RunAction* fRunAction = nullptr;
     const DetectorConstruction* fDetConstruction = nullptr;
+    EventAction* fEventAction = nullptr;
 };
 
 #endif
@@ -0,0 +1,232 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/SweepServer.cc
+/// \brief Implementation of the SweepServer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SweepServer.hh"
+
+#include "Benchmark.hh"
+#include "Shard.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+#include "G4UImanager.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#ifndef _WIN32
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+SweepServer::SweepServer(const G4String& jobFile, G4int jobs)
+  : fJobFile(jobFile)
+  , fJobs(jobs > 0 ? jobs : G4Threading::G4GetNumberOfCores())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4int SweepServer::Run()
+{
+  if(!ReadJobs())
+    return -1;
+
+  // geometry and physics tables, built once and shared by the children,
+  // whose benchmark reports take this as their initialization time
+  G4RunManager::GetRunManager()->BeamOn(0);
+  Benchmark::Instance()->BeginOfRun();
+  G4cout << "Sweep " << fJobFile << ": " << fCommands.size() << " jobs, "
+         << fJobs << " at a time" << G4endl;
+
+  G4int failed = 0;
+#ifdef _WIN32
+  G4Exception("SweepServer::Run", "OpNovice2_024", JustWarning,
+              "No fork on this platform; the jobs run one after the other "
+              "in this process.");
+  for(std::size_t job = 0; job < fCommands.size(); ++job)
+  {
+    if(!RunJob(job))
+      ++failed;
+  }
+#else
+  std::map<pid_t, std::size_t> running;
+  std::size_t next = 0;
+  while(next < fCommands.size() || !running.empty())
+  {
+    if(next < fCommands.size() && G4int(running.size()) < fJobs)
+    {
+      // buffered output would be written again by the child
+      G4cout << std::flush;
+      std::fflush(nullptr);
+      pid_t pid = fork();
+      if(pid == 0)
+        _exit(RunJob(next) ? 0 : 1);
+      if(pid < 0)
+      {
+        G4ExceptionDescription ed;
+        ed << "Cannot fork job " << next << ": " << std::strerror(errno);
+        G4Exception("SweepServer::Run", "OpNovice2_024", JustWarning, ed);
+        ++failed;
+      }
+      else
+        running[pid] = next;
+      ++next;
+      continue;
+    }
+
+    int status = 0;
+    pid_t pid  = waitpid(-1, &status, 0);
+    if(pid < 0)
+    {
+      if(errno == EINTR)
+        continue;
+      break;
+    }
+    auto child = running.find(pid);
+    if(child == running.end())
+      continue;
+    std::size_t job = child->second;
+    running.erase(child);
+    if(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+    {
+      G4cout << "Job " << job << " done (" << LogFileName(job) << ")"
+             << G4endl;
+      continue;
+    }
+    ++failed;
+    G4cout << "Job " << job << " FAILED (";
+    if(WIFSIGNALED(status))
+      G4cout << "signal " << WTERMSIG(status);
+    else
+      G4cout << "exit " << WEXITSTATUS(status);
+    G4cout << ", " << LogFileName(job) << ")" << G4endl;
+  }
+#endif
+  G4cout << "Sweep " << fJobFile << ": " << fCommands.size() - failed
+         << " of " << fCommands.size() << " jobs done" << G4endl;
+  return failed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool SweepServer::ReadJobs()
+{
+  fCommands.clear();
+  std::ifstream in(fJobFile);
+  std::string line;
+  while(std::getline(in, line))
+  {
+    auto first = line.find_first_not_of(" \t\r");
+    if(first == std::string::npos || line[first] == '#')
+      continue;
+    std::vector<G4String> commands;
+    std::istringstream is(line);
+    std::string command;
+    while(std::getline(is, command, ';'))
+    {
+      auto begin = command.find_first_not_of(" \t\r");
+      if(begin == std::string::npos)
+        continue;
+      auto end = command.find_last_not_of(" \t\r");
+      commands.push_back(command.substr(begin, end - begin + 1));
+    }
+    fCommands.push_back(commands);
+  }
+  if(fCommands.empty())
+  {
+    G4ExceptionDescription ed;
+    ed << "No job in " << fJobFile << "; sweep not started.";
+    G4Exception("SweepServer::ReadJobs", "OpNovice2_024", JustWarning, ed);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool SweepServer::RunJob(std::size_t job) const
+{
+#ifndef _WIN32
+  // G4cout goes to std::cout, so the whole output of the job is in its log
+  int fd = open(LogFileName(job).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if(fd >= 0)
+  {
+    dup2(fd, 1);
+    dup2(fd, 2);
+    close(fd);
+  }
+#endif
+  // output files of the job get a _job<k> suffix
+  auto shard            = Shard::Instance();
+  auto analysis         = G4AnalysisManager::Instance();
+  G4String analysisFile = analysis->GetFileName();
+  shard->SetJob(G4int(job));
+
+  auto UImanager = G4UImanager::GetUIpointer();
+  G4bool ok      = true;
+  for(const auto& command : fCommands[job])
+  {
+    G4cout << "Job " << job << ": " << command << G4endl;
+    if(UImanager->ApplyCommand(command) != fCommandSucceeded)
+    {
+      G4cout << "Job " << job << ": command failed, job stopped" << G4endl;
+      ok = false;
+      break;
+    }
+  }
+  // for the next job when they run in this process
+  shard->SetJob(-1);
+  analysis->SetFileName(analysisFile);
+  G4cout << std::flush;
+  std::fflush(nullptr);
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4String SweepServer::LogFileName(std::size_t job) const
+{
+  // JOBS.txt -> JOBS_job<k>.log, next to the job file
+  std::size_t slash = fJobFile.find_last_of("/\\");
+  std::size_t dot   = fJobFile.find_last_of('.');
+  G4String base     = fJobFile;
+  if(dot != std::string::npos &&
+     dot > (slash == std::string::npos ? 0 : slash + 1))
+    base = fJobFile.substr(0, dot);
+  std::ostringstream name;
+  name << base << "_job" << job << ".log";
+  return name.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
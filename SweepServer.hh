@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/SweepServer.hh
+/// \brief Definition of the SweepServer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SweepServer_h
+#define SweepServer_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Parameter sweep run from one initialized process image
+/// (OpNovice2 --sweep JOBS [--jobs J] [setup.mac]).
+///
+/// After the setup macro, a /run/beamOn 0 closes the geometry and builds
+/// the physics tables once. Every job, a line of JOBS with UI commands
+/// separated by ';', then runs in a child forked from this process, which
+/// shares the tables copy-on-write instead of building its own. At most J
+/// children (default: the number of cores) run at a time, taking the jobs
+/// in order as others end; the output of job k goes to JOBS_job<k>.log,
+/// and its output files get a _job<k> suffix (see Shard::FileName).
+///
+/// The run manager must be serial: threads do not survive fork, and the
+/// children are the parallelism. Without fork (Windows) the jobs run one
+/// after the other in this process.
+
+class SweepServer
+{
+ public:
+  SweepServer(const G4String& jobFile, G4int jobs);
+
+  // number of failed jobs, or -1 if there is no job to run
+  G4int Run();
+
+ private:
+  G4bool ReadJobs();
+  // in the child; true if every command succeeded
+  G4bool RunJob(std::size_t job) const;
+  G4String LogFileName(std::size_t job) const;
+
+  G4String fJobFile;
+  G4int fJobs;
+  std::vector<std::vector<G4String>> fCommands;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -56,7 +56,8 @@ TrackInformation::TrackInformation(const G4Track*)
 TrackInformation::TrackInformation(const TrackInformation* aTrackInfo)
   : G4VUserTrackInformation()
 {
-  fFirstTankX = aTrackInfo->fFirstTankX;
+  fFirstTankX   = aTrackInfo->fFirstTankX;
+  fPrimaryIndex = aTrackInfo->fPrimaryIndex;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -66,7 +67,8 @@ TrackInformation::~TrackInformation() = default;
 TrackInformation& TrackInformation::operator=(
   const TrackInformation& aTrackInfo)
 {
-  fFirstTankX = aTrackInfo.fFirstTankX;
+  fFirstTankX   = aTrackInfo.fFirstTankX;
+  fPrimaryIndex = aTrackInfo.fPrimaryIndex;
 
   return *this;
 }
@@ -81,6 +83,7 @@ void TrackInformation::SetSourceTrackInformation(const G4Track*)
 void TrackInformation::Print() const
 {
   G4cout << "first time track incident on X: " << fFirstTankX << G4endl;
+  G4cout << "descends from primary: " << fPrimaryIndex << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -60,9 +60,27 @@ class TrackInformation : public G4VUserTrackInformation
   inline G4int GetReflectionNumber() const { return fReflectionNumber; }
   inline void IncrementReflectionNumber() { ++fReflectionNumber; }
 
+  // reflections on the wrapping only, for reflectivity reweighting
+  inline G4int GetWrapReflectionNumber() const
+  {
+    return fWrapReflectionNumber;
+  }
+  inline void IncrementWrapReflectionNumber() { ++fWrapReflectionNumber; }
+
+  // path length inside the CsI, for absorption-length reweighting
+  inline G4double GetTankPathLength() const { return fTankPathLength; }
+  inline void AddTankPathLength(G4double l) { fTankPathLength += l; }
+
+  // index of the primary this track descends from, within its event
+  inline G4int GetPrimaryIndex() const { return fPrimaryIndex; }
+  inline void SetPrimaryIndex(G4int i) { fPrimaryIndex = i; }
+
  private:
   G4bool fFirstTankX = false;
   G4int fReflectionNumber = 0;
+  G4int fWrapReflectionNumber = 0;
+  G4double fTankPathLength = 0.;
+  G4int fPrimaryIndex = 0;
 };
 
 extern G4ThreadLocal G4Allocator<TrackInformation>* aTrackInformationAllocator;
@@ -45,6 +45,9 @@ void TrackingAction::PreUserTrackingAction(const G4Track* aTrack)
   {
     trackInfo = new TrackInformation(aTrack);
     trackInfo->SetIsFirstTankX(true);
+    // primaries get track IDs 1..K in the order they were generated
+    if(aTrack->GetParentID() == 0)
+      trackInfo->SetPrimaryIndex(aTrack->GetTrackID() - 1);
     aTrack->SetUserInformation(trackInfo);
   }
 
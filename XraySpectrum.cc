@@ -0,0 +1,234 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/XraySpectrum.cc
+/// \brief Implementation of the XraySpectrum class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "XraySpectrum.hh"
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace
+{
+G4Mutex spectrumMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::shared_ptr<const XraySpectrum> XraySpectrum::Load(
+  const G4String& fileName)
+{
+  // one table per file for the whole process; workers only read it
+  static std::map<G4String, std::shared_ptr<const XraySpectrum>> cache;
+
+  G4AutoLock lock(&spectrumMutex);
+  auto it = cache.find(fileName);
+  if(it != cache.end())
+    return it->second;
+
+  std::ifstream in(fileName);
+  if(!in)
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot open X-ray spectrum file " << fileName;
+    G4Exception("XraySpectrum::Load", "OpNovice2_005", FatalException, ed);
+    return nullptr;
+  }
+
+  std::vector<G4double> energies;
+  std::vector<G4double> fluences;
+  std::string line;
+  while(std::getline(in, line))
+  {
+    auto first = line.find_first_not_of(" \t\r");
+    if(first == std::string::npos || line[first] == '#')
+      continue;
+    std::istringstream is(line);
+    G4double en = 0.;
+    G4double fl = 0.;
+    if(is >> en >> fl)
+    {
+      energies.push_back(en * keV);
+      fluences.push_back(fl);
+    }
+  }
+
+  auto spectrum = std::make_shared<XraySpectrum>(energies, fluences);
+  spectrum->fName = fileName;
+  cache[fileName] = spectrum;
+
+  G4cout << "X-ray spectrum " << fileName << ": " << energies.size()
+         << " points, " << spectrum->GetMinEnergy() / keV << " - "
+         << spectrum->GetMaxEnergy() / keV << " keV, mean "
+         << spectrum->GetMeanEnergy() / keV << " keV" << G4endl;
+  return spectrum;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+std::shared_ptr<const XraySpectrum> XraySpectrum::Flat(G4double emin,
+                                                       G4double emax)
+{
+  auto spectrum =
+    std::make_shared<XraySpectrum>(std::vector<G4double>{ emin, emax },
+                                   std::vector<G4double>{ 1., 1. });
+  std::ostringstream name;
+  name << "flat " << emin / keV << "-" << emax / keV << " keV";
+  spectrum->fName = name.str();
+  return spectrum;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+XraySpectrum::XraySpectrum(const std::vector<G4double>& energies,
+                           const std::vector<G4double>& fluences)
+  : fEnergies(energies)
+  , fFluences(fluences)
+{
+  std::size_t n = std::min(fEnergies.size(), fFluences.size());
+  fEnergies.resize(n);
+  fFluences.resize(n);
+
+  G4bool sorted = std::is_sorted(fEnergies.begin(), fEnergies.end());
+  G4bool positive = std::none_of(fFluences.begin(), fFluences.end(),
+                                 [](G4double f) { return f < 0.; });
+  if(n < 2 || !sorted || !positive)
+  {
+    G4ExceptionDescription ed;
+    ed << "An X-ray spectrum needs at least two points with increasing "
+       << "energy and non-negative fluence.";
+    G4Exception("XraySpectrum::XraySpectrum", "OpNovice2_006",
+                FatalException, ed);
+    return;
+  }
+
+  // trapezoid weight of every interval
+  std::vector<G4double> weights(n - 1);
+  G4double moment = 0.;
+  for(std::size_t i = 0; i < n - 1; ++i)
+  {
+    G4double width = fEnergies[i + 1] - fEnergies[i];
+    weights[i]     = 0.5 * (fFluences[i] + fFluences[i + 1]) * width;
+    fNorm += weights[i];
+    // first moment of the linear density over the interval
+    moment += width *
+              (fFluences[i] * (2. * fEnergies[i] + fEnergies[i + 1]) +
+               fFluences[i + 1] * (fEnergies[i] + 2. * fEnergies[i + 1])) /
+              6.;
+  }
+  if(fNorm <= 0.)
+  {
+    G4Exception("XraySpectrum::XraySpectrum", "OpNovice2_006",
+                FatalException, "X-ray spectrum has zero integral.");
+    return;
+  }
+  fMeanEnergy = moment / fNorm;
+
+  BuildAliasTable(weights);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void XraySpectrum::BuildAliasTable(const std::vector<G4double>& weights)
+{
+  // Vose's method: split the scaled weights into under- and over-full
+  // columns and top up each small column from a large one.
+  std::size_t n = weights.size();
+  fProb.assign(n, 1.);
+  fAlias.resize(n);
+  for(std::size_t i = 0; i < n; ++i)
+    fAlias[i] = i;
+
+  std::vector<G4double> scaled(n);
+  std::vector<std::size_t> small;
+  std::vector<std::size_t> large;
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    scaled[i] = weights[i] * n / fNorm;
+    (scaled[i] < 1. ? small : large).push_back(i);
+  }
+
+  while(!small.empty() && !large.empty())
+  {
+    std::size_t s = small.back();
+    small.pop_back();
+    std::size_t l = large.back();
+
+    fProb[s]  = scaled[s];
+    fAlias[s] = l;
+    scaled[l] -= 1. - scaled[s];
+    if(scaled[l] < 1.)
+    {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // whatever is left is full up to rounding
+  for(auto i : small)
+    fProb[i] = 1.;
+  for(auto i : large)
+    fProb[i] = 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double XraySpectrum::SampleEnergy() const
+{
+  std::size_t n = fProb.size();
+  auto i        = std::min(std::size_t(G4UniformRand() * n), n - 1);
+  if(G4UniformRand() >= fProb[i])
+    i = fAlias[i];
+
+  // invert the linear density a + (b-a)x on [0,1]
+  G4double a = fFluences[i];
+  G4double b = fFluences[i + 1];
+  G4double u = G4UniformRand();
+  G4double x = u;
+  if(std::abs(b - a) > 1.e-9 * (a + b))
+    x = (std::sqrt(a * a + (b * b - a * a) * u) - a) / (b - a);
+
+  return fEnergies[i] + x * (fEnergies[i + 1] - fEnergies[i]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4double XraySpectrum::Density(G4double e) const
+{
+  if(e < fEnergies.front() || e > fEnergies.back() || fNorm <= 0.)
+    return 0.;
+  auto it = std::upper_bound(fEnergies.begin(), fEnergies.end(), e);
+  std::size_t i =
+    std::min(std::size_t(it - fEnergies.begin()), fEnergies.size() - 1) - 1;
+  G4double x = (e - fEnergies[i]) / (fEnergies[i + 1] - fEnergies[i]);
+  return (fFluences[i] + x * (fFluences[i + 1] - fFluences[i])) / fNorm;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/XraySpectrum.hh
+/// \brief Definition of the XraySpectrum class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef XraySpectrum_h
+#define XraySpectrum_h 1
+
+#include "globals.hh"
+
+#include <memory>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Tabulated X-ray tube spectrum, sampled in O(1) with a Walker alias table.
+///
+/// The file holds two columns, energy [keV] and fluence (arbitrary units).
+/// Lines starting with '#' are ignored. The spectrum is treated as piecewise
+/// linear between the tabulated points: the alias table picks an interval,
+/// then the energy is drawn from the linear density inside it.
+///
+/// Spectra are immutable once built. Load() caches them by file name, so all
+/// worker threads share one read-only table.
+
+class XraySpectrum
+{
+ public:
+  static std::shared_ptr<const XraySpectrum> Load(const G4String& fileName);
+  // uniform reference spectrum between emin and emax
+  static std::shared_ptr<const XraySpectrum> Flat(G4double emin,
+                                                  G4double emax);
+
+  XraySpectrum(const std::vector<G4double>& energies,
+               const std::vector<G4double>& fluences);
+  ~XraySpectrum() = default;
+
+  G4double SampleEnergy() const;
+
+  // normalized probability density at energy e (zero outside the table)
+  G4double Density(G4double e) const;
+
+  G4double GetMinEnergy() const { return fEnergies.front(); }
+  G4double GetMaxEnergy() const { return fEnergies.back(); }
+  G4double GetMeanEnergy() const { return fMeanEnergy; }
+  const G4String& GetName() const { return fName; }
+  const std::vector<G4double>& GetEnergies() const { return fEnergies; }
+  const std::vector<G4double>& GetFluences() const { return fFluences; }
+
+ private:
+  void BuildAliasTable(const std::vector<G4double>& weights);
+
+  G4String fName;
+  std::vector<G4double> fEnergies;
+  std::vector<G4double> fFluences;
+  G4double fNorm = 0.;
+  G4double fMeanEnergy = 0.;
+
+  // alias table over the intervals [E_i, E_i+1)
+  std::vector<G4double> fProb;
+  std::vector<std::size_t> fAlias;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
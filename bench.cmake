@@ -0,0 +1,51 @@
+#----------------------------------------------------------------------------
+# Benchmark driver, run by the 'bench' target:
+#   cmake -DEXE=<OpNovice2> [-DOUTPUT=bench.jsonl] [-DTHREADS="1;2;4"]
+#         [-DWORKLOADS="gamma20keV;optical"] -P bench.cmake
+# Every workload macro bench_<name>.mac is run once per thread count, in
+# the current directory, with the thread count forced through
+# G4FORCENUMBEROFTHREADS. Each run appends one JSON line to OUTPUT and
+# its log goes to bench_<name>_<threads>.log.
+#
+if(NOT EXE)
+  message(FATAL_ERROR "bench.cmake: set EXE to the OpNovice2 executable")
+endif()
+if(NOT OUTPUT)
+  set(OUTPUT bench.jsonl)
+endif()
+if(NOT WORKLOADS)
+  set(WORKLOADS gamma20keV gamma100keV electron optical)
+endif()
+if(NOT THREADS)
+  # 1, 2, 4, 8 and all cores, without going beyond the machine
+  cmake_host_system_information(RESULT _cores QUERY NUMBER_OF_LOGICAL_CORES)
+  set(THREADS)
+  foreach(_n 1 2 4 8)
+    if(_n LESS _cores)
+      list(APPEND THREADS ${_n})
+    endif()
+  endforeach()
+  list(APPEND THREADS ${_cores})
+endif()
+
+file(REMOVE ${OUTPUT})
+foreach(_workload ${WORKLOADS})
+  foreach(_n ${THREADS})
+    message(STATUS "bench: ${_workload}, ${_n} threads")
+    execute_process(
+      COMMAND ${CMAKE_COMMAND} -E env G4FORCENUMBEROFTHREADS=${_n}
+              OPNOVICE2_BENCH_FILE=${OUTPUT} ${EXE} bench_${_workload}.mac
+      OUTPUT_FILE bench_${_workload}_${_n}.log
+      ERROR_FILE bench_${_workload}_${_n}.log
+      RESULT_VARIABLE _status)
+    if(NOT _status EQUAL 0)
+      message(WARNING "bench: ${_workload} with ${_n} threads failed "
+                      "(${_status}), see bench_${_workload}_${_n}.log")
+    endif()
+  endforeach()
+endforeach()
+
+if(EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} _results)
+  message(STATUS "bench: results in ${OUTPUT}\n${_results}")
+endif()
@@ -0,0 +1,65 @@
+"""Read the per-event summary written by /opnovice2/tuple/file.
+
+The file is a block file (magic OPN2TUPL): every block holds one column of
+one row group, and the index key range of the block is (column, row group).
+Columns are returned as numpy arrays, in file order.
+"""
+import struct
+import zlib
+
+import numpy as np
+
+COLUMNS = [
+    ("event_id", np.int32),
+    ("energy_keV", np.float32),
+    ("scintillation", np.int32),
+    ("detected", np.int32),
+    ("edep_keV", np.float32),
+    ("depth_mm", np.float32),
+]
+
+
+def read_event_tuple(path, columns=None):
+    wanted = [name for name, _ in COLUMNS] if columns is None else columns
+    with open(path, "rb") as f:
+        header = f.read(32)
+        if header[:8] != b"OPN2TUPL":
+            raise ValueError(f"{path} is not an event tuple file")
+        version, record_size, _ = struct.unpack("<3I", header[8:20])
+        if version != 1 or record_size != 4:
+            raise ValueError(f"{path}: unsupported version {version}")
+
+        f.seek(-24, 2)
+        index_offset, n_blocks = struct.unpack("<2Q", f.read(16))
+        if f.read(8) != b"OPN2INDX":
+            raise ValueError(f"{path} is incomplete (no index)")
+        f.seek(index_offset)
+        index = np.frombuffer(
+            f.read(24 * n_blocks),
+            dtype=[("offset", "<u8"), ("rows", "<u4"), ("stored", "<u4"),
+                   ("column", "<i4"), ("group", "<i4")])
+
+        result = {}
+        for col, (name, dtype) in enumerate(COLUMNS):
+            if name not in wanted:
+                continue
+            parts = []
+            for entry in np.sort(index[index["column"] == col], order="group"):
+                f.seek(int(entry["offset"]) + 8)
+                data = f.read(int(entry["stored"]))
+                if entry["stored"] != 4 * entry["rows"]:
+                    data = zlib.decompress(data)
+                parts.append(np.frombuffer(data, dtype=dtype))
+            result[name] = np.concatenate(parts) if parts else np.empty(0, dtype)
+        return result
+
+
+if __name__ == "__main__":
+    import sys
+
+    events = read_event_tuple(sys.argv[1])
+    n = len(events["event_id"])
+    print(f"{n} events")
+    for name, values in events.items():
+        if n:
+            print(f"  {name:14s} mean {values.mean():12.4g}  rms {values.std():12.4g}")
@@ -0,0 +1,164 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/merge.cc
+/// \brief Merges the run state files of a run split with --shard
+//
+// Adds the RunState files written by the shards of a run (OpNovice2
+// --shard i/N) as the master adds its worker runs: Run::Merge for the
+// counters, maps and moments, bin by bin for the analysis-manager H1s.
+// Run::EndOfRun then normalizes the total once, and the outputs of the
+// macro (resolution, arrival spectrum, reweighting, response, ...) are
+// written as at the end of an unsplit run. The state files record shard
+// i/N and the run ID: shards of different runs or a shard given twice
+// are rejected.
+//
+// usage: OpNovice2Merge [--macro FILE] output shard.state...
+// The macro should be the one of the shards, without /run/beamOn; output
+// is the analysis file of the merged histograms.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ActionInitialization.hh"
+#include "DetectorConstruction.hh"
+#include "PrimaryGeneratorAction.hh"
+#include "Run.hh"
+#include "RunAction.hh"
+#include "RunState.hh"
+
+// Include the implementation directly, as in OpNovice2.cc
+#include "src/CustomOpticalPhysics.cc"
+
+#include "FTFP_BERT.hh"
+#include "G4AnalysisManager.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4RunManagerFactory.hh"
+#include "G4UImanager.hh"
+
+#include <algorithm>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  G4String macro;
+  std::vector<G4String> args;
+  for(G4int i = 1; i < argc; ++i)
+  {
+    G4String arg = argv[i];
+    if(arg == "--macro" && i + 1 < argc)
+      macro = argv[++i];
+    else
+      args.push_back(arg);
+  }
+  if(args.size() < 2)
+  {
+    G4cerr << "usage: " << argv[0]
+           << " [--macro FILE] output shard.state..." << G4endl;
+    return 1;
+  }
+
+  auto runManager =
+    G4RunManagerFactory::CreateRunManager(G4RunManagerType::SerialOnly);
+  runManager->SetUserInitialization(new DetectorConstruction());
+  G4VModularPhysicsList* physicsList = new FTFP_BERT(0);
+  physicsList->ReplacePhysics(new G4EmStandardPhysics_option4());
+  physicsList->RegisterPhysics(new CustomOpticalPhysics(0, "Optical"));
+  runManager->SetUserInitialization(physicsList);
+  runManager->SetUserInitialization(new ActionInitialization());
+  runManager->Initialize();
+  if(!macro.empty())
+    G4UImanager::GetUIpointer()->ApplyCommand("/control/execute " + macro);
+
+  // the first shard is read into the total, the others added to it; all
+  // must be distinct shards of the same run
+  auto total = new Run();
+  RunProgress first;
+  std::vector<G4bool> merged;
+  for(std::size_t i = 1; i < args.size(); ++i)
+  {
+    G4cout << "Merging " << args[i] << G4endl;
+    Run shard;
+    RunProgress header;
+    if(!RunState::Read(args[i], i == 1 ? *total : shard, &header))
+      return 1;
+    if(i == 1)
+    {
+      first = header;
+      merged.assign(std::max(header.fShardCount, 0), false);
+    }
+    if(header.fShardCount < 1 || header.fShardIndex < 0 ||
+       header.fShardIndex >= header.fShardCount)
+    {
+      G4cerr << args[i] << " is not the state file of a shard." << G4endl;
+      return 1;
+    }
+    if(header.fShardCount != first.fShardCount ||
+       header.fRunID != first.fRunID)
+    {
+      G4cerr << args[i] << " is shard " << header.fShardIndex << "/"
+             << header.fShardCount << " of run " << header.fRunID
+             << ", not of run " << first.fRunID << " in "
+             << first.fShardCount << " shards." << G4endl;
+      return 1;
+    }
+    if(merged[header.fShardIndex])
+    {
+      G4cerr << args[i] << ": shard " << header.fShardIndex << "/"
+             << header.fShardCount << " already merged." << G4endl;
+      return 1;
+    }
+    merged[header.fShardIndex] = true;
+    if(i > 1)
+      total->Merge(&shard);
+  }
+  if(args.size() - 1 < merged.size())
+    G4cout << "Warning: " << args.size() - 1 << " of " << merged.size()
+           << " shards of run " << first.fRunID << " merged" << G4endl;
+
+  // the spectrum is not in the state files; it comes from the macro
+  auto primary = static_cast<const PrimaryGeneratorAction*>(
+    runManager->GetUserPrimaryGeneratorAction());
+  total->SetSpectrum(primary->GetSpectrum());
+
+  G4cout << "\n-------- " << args.size() - 1 << " shards, "
+         << total->GetNumberOfEvent() << " events --------" << G4endl;
+  total->PrintScintillationSummary();
+  total->EndOfRun();
+  static_cast<const RunAction*>(runManager->GetUserRunAction())
+    ->Report(total);
+
+  auto analysis = G4AnalysisManager::Instance();
+  analysis->OpenFile(args[0]);
+  analysis->Write();
+  analysis->CloseFile();
+
+  delete total;
+  delete runManager;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,313 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/microbench.cc
+/// \brief Microbenchmarks of the OpNovice2 user code
+//
+// Times the hot user code in isolation from the Geant4 kernel:
+//  - SteppingAction::UserSteppingAction on synthetic steps (boundary
+//    reflection, detection, absorption, Rayleigh scattering and a step
+//    producing scintillation photons),
+//  - Run::Merge of many worker runs into a master run,
+//  - Run::EndOfRun, including the histogram normalization loops, with the
+//    printout suppressed.
+//
+// usage: OpNovice2Microbench [iterations=1000000] [workerRuns=64] [macro]
+// The optional macro is executed after initialization, e.g. to enable the
+// outputs (resolution, reweighting targets, ...) whose cost is wanted.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ActionInitialization.hh"
+#include "DetectorConstruction.hh"
+#include "Run.hh"
+#include "TrackInformation.hh"
+
+// Include the implementation directly, as in OpNovice2.cc
+#include "src/CustomOpticalPhysics.cc"
+
+#include "FTFP_BERT.hh"
+#include "G4AnalysisManager.hh"
+#include "G4DynamicParticle.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4Electron.hh"
+#include "G4Event.hh"
+#include "G4Navigator.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4ProcessTable.hh"
+#include "G4RunManagerFactory.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+#include "G4UImanager.hh"
+#include "G4UserEventAction.hh"
+#include "G4UserRunAction.hh"
+#include "G4UserSteppingAction.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// time per call of f, in ns
+G4double Time(G4int iterations, const std::function<void()>& f)
+{
+  auto start = Clock::now();
+  for(G4int i = 0; i < iterations; ++i)
+    f();
+  std::chrono::duration<G4double, std::nano> elapsed = Clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+void Report(const G4String& name, G4int iterations, G4double ns)
+{
+  G4cout << std::left << std::setw(40) << name << std::right << std::setw(10)
+         << iterations << std::setw(14) << std::setprecision(4) << ns
+         << G4endl;
+}
+
+G4TouchableHandle Locate(const G4ThreeVector& position)
+{
+  G4Navigator* navigator = G4TransportationManager::GetTransportationManager()
+                             ->GetNavigatorForTracking();
+  navigator->LocateGlobalPointAndSetup(position, nullptr, false, true);
+  return G4TouchableHandle(navigator->CreateTouchableHistory());
+}
+
+G4Track* MakeTrack(G4ParticleDefinition* particle, G4double energy,
+                   const G4ThreeVector& position, G4int trackID)
+{
+  auto track = new G4Track(
+    new G4DynamicParticle(particle, G4ThreeVector(0., 0., 1.), energy), 0.,
+    position);
+  track->SetTrackID(trackID);
+  track->SetParentID(1);
+  track->SetUserInformation(new TrackInformation(track));
+  // not the first step, as most steps of a photon
+  track->IncrementCurrentStepNumber();
+  track->IncrementCurrentStepNumber();
+  return track;
+}
+
+G4Step* MakeStep(G4Track* track, const G4TouchableHandle& pre,
+                 const G4TouchableHandle& post, const G4ThreeVector& prePos,
+                 const G4ThreeVector& postPos, G4StepStatus status,
+                 const G4VProcess* process)
+{
+  auto step = new G4Step();
+  step->NewSecondaryVector();
+  step->SetTrack(track);
+  track->SetStep(step);
+  step->SetStepLength((postPos - prePos).mag());
+  step->GetPreStepPoint()->SetTouchableHandle(pre);
+  step->GetPreStepPoint()->SetPosition(prePos);
+  step->GetPostStepPoint()->SetTouchableHandle(post);
+  step->GetPostStepPoint()->SetPosition(postPos);
+  step->GetPostStepPoint()->SetStepStatus(status);
+  step->GetPostStepPoint()->SetProcessDefinedStep(process);
+  return step;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  G4int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  G4int workerRuns = argc > 2 ? std::atoi(argv[2]) : 64;
+  if(iterations < 1 || workerRuns < 1)
+  {
+    G4cerr << "usage: " << argv[0]
+           << " [iterations=1000000] [workerRuns=64] [macro]"
+           << " (counts >= 1)" << G4endl;
+    return 1;
+  }
+
+  auto runManager =
+    G4RunManagerFactory::CreateRunManager(G4RunManagerType::SerialOnly);
+  auto detector = new DetectorConstruction();
+  runManager->SetUserInitialization(detector);
+  G4VModularPhysicsList* physicsList = new FTFP_BERT(0);
+  physicsList->ReplacePhysics(new G4EmStandardPhysics_option4());
+  physicsList->RegisterPhysics(new CustomOpticalPhysics(0, "Optical"));
+  runManager->SetUserInitialization(physicsList);
+  runManager->SetUserInitialization(new ActionInitialization());
+  runManager->Initialize();
+
+  if(argc > 3)
+    G4UImanager::GetUIpointer()->ApplyCommand(G4String("/control/execute ") +
+                                              argv[3]);
+
+  // the histograms normalized at end of run
+  auto analysis = G4AnalysisManager::Instance();
+  std::vector<G4int> normalized = {
+    analysis->GetH1Id("Fresnel refraction"),
+    analysis->GetH1Id("Fresnel reflection plus TIR"),
+    analysis->GetH1Id("Fresnel reflection")
+  };
+  for(G4int id : normalized)
+    analysis->SetH1Activation(id, true);
+
+  auto runAction = const_cast<G4UserRunAction*>(runManager->GetUserRunAction());
+  auto eventAction =
+    const_cast<G4UserEventAction*>(runManager->GetUserEventAction());
+  auto stepping =
+    const_cast<G4UserSteppingAction*>(runManager->GetUserSteppingAction());
+
+  // worker runs first: GenerateRun also sets the run of the RunAction,
+  // which RunInitialization below points back to the current run
+  std::vector<Run*> workers;
+  for(G4int i = 0; i < workerRuns; ++i)
+    workers.push_back(static_cast<Run*>(runAction->GenerateRun()));
+  auto master = static_cast<Run*>(runAction->GenerateRun());
+
+  if(!runManager->ConfirmBeamOnCondition())
+    return 1;
+  runManager->RunInitialization();
+  auto run = static_cast<Run*>(runManager->GetNonConstCurrentRun());
+
+  G4Event event(0);
+  eventAction->BeginOfEventAction(&event);
+
+  // points in the CsI, in the world below it and in the photodiode
+  G4ThreeVector inTank(0., 0., 0.);
+  G4ThreeVector inWorld(0., 0., -detector->GetTankZ() - 1. * mm);
+  G4ThreeVector inPD = G4PhysicalVolumeStore::GetInstance()
+                         ->GetVolume("Photodiode")
+                         ->GetTranslation();
+  G4TouchableHandle tank  = Locate(inTank);
+  G4TouchableHandle world = Locate(inWorld);
+  G4TouchableHandle pd    = Locate(inPD);
+
+  auto processes = G4ProcessTable::GetProcessTable();
+  auto boundary  = processes->FindProcess("OpBoundary", "opticalphoton");
+  auto absorption = processes->FindProcess("OpAbsorption", "opticalphoton");
+  auto rayleigh  = processes->FindProcess("OpRayleigh", "opticalphoton");
+  auto scintillation = processes->FindProcess("Scintillation", "e-");
+  auto ionisation    = processes->FindProcess("eIoni", "e-");
+  G4ParticleDefinition* photon = G4OpticalPhoton::Definition();
+
+  struct Case
+  {
+    G4String fName;
+    G4Step* fStep;
+  };
+  std::vector<Case> cases;
+  auto photonTrack = [&](G4int id) {
+    return MakeTrack(photon, 2.5 * eV, inTank, id);
+  };
+  cases.push_back({ "step: boundary reflection",
+                    MakeStep(photonTrack(2), tank, world, inTank, inWorld,
+                             fGeomBoundary, boundary) });
+  cases.push_back({ "step: detection", MakeStep(photonTrack(3), tank, pd,
+                                                inTank, inPD, fGeomBoundary,
+                                                boundary) });
+  cases.push_back({ "step: absorption",
+                    MakeStep(photonTrack(4), tank, tank, inTank, inTank,
+                             fPostStepDoItProc, absorption) });
+  cases.push_back({ "step: Rayleigh", MakeStep(photonTrack(5), tank, tank,
+                                               inTank, inTank,
+                                               fPostStepDoItProc, rayleigh) });
+
+  // an electron step in the CsI creating ten scintillation photons
+  auto electron = MakeTrack(G4Electron::Definition(), 10. * keV, inTank, 6);
+  auto electronStep = MakeStep(electron, tank, tank, inTank, inTank,
+                               fPostStepDoItProc, ionisation);
+  electronStep->SetTotalEnergyDeposit(1. * keV);
+  for(G4int i = 0; i < 10; ++i)
+  {
+    auto secondary = MakeTrack(photon, 2.5 * eV, inTank, 100 + i);
+    secondary->SetCreatorProcess(scintillation);
+    electronStep->GetfSecondary()->push_back(secondary);
+  }
+  cases.push_back({ "step: 10 scintillation secondaries", electronStep });
+
+  G4cout << "\n-------- Microbenchmarks --------" << G4endl;
+  G4cout << std::left << std::setw(40) << "case" << std::right
+         << std::setw(10) << "calls" << std::setw(14) << "ns/call" << G4endl;
+
+  for(const auto& c : cases)
+  {
+    G4Step* step   = c.fStep;
+    G4Track* track = step->GetTrack();
+    G4double ns    = Time(iterations, [stepping, step, track]() {
+      // detection kills the photon
+      track->SetTrackStatus(fAlive);
+      stepping->UserSteppingAction(step);
+    });
+    Report(c.fName, iterations, ns);
+  }
+
+  // the worker runs get the content of the stepping loops above
+  for(auto worker : workers)
+  {
+    worker->RecordEvent(&event);
+    worker->Merge(run);
+  }
+  // as at the end of a run with workerRuns threads, repeated
+  G4int merges   = std::max(1, iterations / 100000);
+  G4double merge = Time(merges, [&workers, master]() {
+    for(auto worker : workers)
+      master->Merge(worker);
+  });
+  Report("Run::Merge (" + std::to_string(workerRuns) + " worker runs)", merges,
+         merge);
+
+  // end of run on the merged content, fresnel histograms filled
+  for(G4int id : normalized)
+  {
+    for(G4int i = 0; i < 1000; ++i)
+      analysis->FillH1(id, (i % 90) + 0.5);
+  }
+  G4int endOfRuns = std::max(1, iterations / 10000);
+  G4cout.setstate(std::ios::badbit);
+  G4double endOfRun = Time(endOfRuns, [master]() { master->EndOfRun(); });
+  G4cout.clear();
+  Report("Run::EndOfRun (no printout)", endOfRuns, endOfRun);
+
+  for(const auto& c : cases)
+  {
+    delete c.fStep->GetTrack();
+    for(auto secondary : *c.fStep->GetfSecondary())
+      delete secondary;
+    delete c.fStep;
+  }
+  for(auto worker : workers)
+    delete worker;
+  delete master;
+
+  runManager->RunTermination();
+  delete runManager;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,52 @@
+#----------------------------------------------------------------------------
+# Reproducibility check, run by the 'reproducibility' test:
+#   cmake -DEXE=<OpNovice2> [-DMACRO=reproducibility.mac] [-DTHREADS="1;4"]
+#         -P reproducibility.cmake
+# MACRO, which should set /opnovice2/gun/eventSeed, is run once per thread
+# count, in the current directory, with the thread count forced through
+# G4FORCENUMBEROFTHREADS; its log goes to reproducibility_<threads>.log.
+# Fails unless every run prints the same reproducibility digest.
+#
+if(NOT EXE)
+  message(FATAL_ERROR
+    "reproducibility.cmake: set EXE to the OpNovice2 executable")
+endif()
+if(NOT MACRO)
+  set(MACRO reproducibility.mac)
+endif()
+if(NOT THREADS)
+  set(THREADS 1 4)
+endif()
+
+set(_reference)
+foreach(_n ${THREADS})
+  message(STATUS "reproducibility: ${MACRO}, ${_n} threads")
+  set(_log reproducibility_${_n}.log)
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E env G4FORCENUMBEROFTHREADS=${_n}
+            ${EXE} ${MACRO}
+    OUTPUT_FILE ${_log}
+    ERROR_FILE ${_log}
+    RESULT_VARIABLE _status)
+  if(NOT _status EQUAL 0)
+    message(FATAL_ERROR "reproducibility: ${MACRO} with ${_n} threads "
+                        "failed (${_status}), see ${_log}")
+  endif()
+
+  file(STRINGS ${_log} _digest REGEX "Reproducibility digest: ")
+  if(NOT _digest)
+    message(FATAL_ERROR "reproducibility: no digest in ${_log}")
+  endif()
+  # the last run of the macro
+  list(GET _digest -1 _digest)
+  string(REGEX REPLACE ".*Reproducibility digest: " "" _digest "${_digest}")
+  message(STATUS "reproducibility: ${_n} threads: ${_digest}")
+  if(NOT _reference)
+    set(_reference "${_digest}")
+    set(_referenceThreads ${_n})
+  elseif(NOT _digest STREQUAL _reference)
+    message(FATAL_ERROR "reproducibility: digest ${_digest} with ${_n} "
+                        "threads, ${_reference} with ${_referenceThreads} "
+                        "threads")
+  endif()
+endforeach()
@@ -0,0 +1,43 @@
+#----------------------------------------------------------------------------
+# Wrap-reflectivity reweighting check, run by the 'reweighting' test:
+#   cmake -DEXE=<OpNovice2> [-DMACRO=reweighting.mac] -P reweighting.cmake
+# MACRO, which should simulate a wrap reflectivity above its
+# /opnovice2/reweight/wrapReflectivity targets, is run in the current
+# directory; its log goes to reweighting.log. Fails unless every target
+# gives a ratio to the simulated yield below 1.
+#
+if(NOT EXE)
+  message(FATAL_ERROR "reweighting.cmake: set EXE to the OpNovice2 executable")
+endif()
+if(NOT MACRO)
+  set(MACRO reweighting.mac)
+endif()
+
+set(_log reweighting.log)
+execute_process(
+  COMMAND ${EXE} ${MACRO}
+  OUTPUT_FILE ${_log}
+  ERROR_FILE ${_log}
+  RESULT_VARIABLE _status)
+if(NOT _status EQUAL 0)
+  message(FATAL_ERROR
+    "reweighting: ${MACRO} failed (${_status}), see ${_log}")
+endif()
+
+# target, detected per event +- error, ratio to simulated +- error
+set(_row "wrap R = ([^ ]+) +[^ ]+ \\+- [^ ]+ +([^ ]+) \\+- ")
+file(STRINGS ${_log} _targets REGEX "${_row}")
+if(NOT _targets)
+  message(FATAL_ERROR "reweighting: no wrap reflectivity target in ${_log}")
+endif()
+foreach(_target ${_targets})
+  string(REGEX MATCH "${_row}" _match "${_target}")
+  set(_reflectivity ${CMAKE_MATCH_1})
+  set(_ratio ${CMAKE_MATCH_2})
+  message(STATUS "reweighting: wrap R = ${_reflectivity}: ratio ${_ratio}")
+  if(NOT _ratio LESS 1)
+    message(FATAL_ERROR "reweighting: wrap R = ${_reflectivity} gives the "
+                        "simulated yield (ratio ${_ratio}); are the wrap "
+                        "reflections counted?")
+  endif()
+endforeach()
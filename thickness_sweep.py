@@ -13,7 +13,12 @@ results = {
     'photons_created': [],
     'photons_detected': [],
     'electrons': [],
-    'detection_efficiency': []
+    'detection_efficiency': [],
+    'absorption': [],
+    'swank': [],
+    'swank_err': [],
+    'dqe': [],
+    'dqe_err': []
 }
 
 # Path to your executable and macro
@@ -70,6 +75,10 @@ for thickness_um, thickness_mm in zip(thicknesses_um, thicknesses_mm):
     photons_created = re.search(r'Total scintillation photons created:\s*(\d+)', output)
     photons_detected = re.search(r'Photons detected at PD \(global\):\s*(\d+)', output)
     electrons = re.search(r'Estimated electrons:\s*([\d.]+)', output)
+    number = r'([-+\d.eE]+)'
+    absorption = re.search(r'Absorption fraction:\s*' + number, output)
+    swank = re.search(r'Swank factor:\s*' + number + r'\s*\+-\s*' + number, output)
+    dqe = re.search(r'DQE\(0\):\s*' + number + r'\s*\+-\s*' + number, output)
     
     if photons_created and photons_detected and electrons:
         created = int(photons_created.group(1))
@@ -82,8 +91,16 @@ for thickness_um, thickness_mm in zip(thicknesses_um, thicknesses_mm):
         results['photons_detected'].append(detected)
         results['electrons'].append(elec)
         results['detection_efficiency'].append(efficiency)
+        results['absorption'].append(float(absorption.group(1)) if absorption else np.nan)
+        results['swank'].append(float(swank.group(1)) if swank else np.nan)
+        results['swank_err'].append(float(swank.group(2)) if swank else np.nan)
+        results['dqe'].append(float(dqe.group(1)) if dqe else np.nan)
+        results['dqe_err'].append(float(dqe.group(2)) if dqe else np.nan)
         
         print(f"  ✓ Created: {created}, Detected: {detected}, Electrons: {elec:.1f}, Eff: {efficiency:.1f}%")
+        if dqe:
+            print(f"    Absorption: {results['absorption'][-1]:.3f}, Swank: {results['swank'][-1]:.3f}, "
+                  f"DQE(0): {results['dqe'][-1]:.3f} +- {results['dqe_err'][-1]:.3f}")
     else:
         print(f"  ERROR: Could not parse output for {thickness_um} μm")
 
@@ -91,7 +108,7 @@ print("\n" + "=" * 60)
 print("Sweep complete! Generating plots...")
 
 # Create figure with multiple subplots
-fig, axes = plt.subplots(2, 2, figsize=(14, 10))
+fig, axes = plt.subplots(2, 3, figsize=(20, 10))
 fig.suptitle('CsI Thickness Optimization for TDI Camera', fontsize=16, fontweight='bold')
 
 # Plot 1: Scintillation photons created
@@ -137,6 +154,29 @@ ax4.set_ylabel('Photons Detected at PD', fontsize=12)
 ax4.set_title('Collected Scintillation Photons', fontsize=13)
 ax4.grid(True, alpha=0.3)
 
+# Plot 5: DQE(0), the figure of merit, with its 95% interval
+ax5 = axes[0, 2]
+ax5.errorbar(results['thickness_um'], results['dqe'], yerr=results['dqe_err'],
+             fmt='k-o', linewidth=2, markersize=6, capsize=3)
+ax5.set_xlabel('CsI Thickness (μm)', fontsize=12)
+ax5.set_ylabel('DQE(0)', fontsize=12)
+ax5.set_title('Zero-Frequency DQE', fontsize=13)
+ax5.grid(True, alpha=0.3)
+if np.any(np.isfinite(results['dqe'])):
+    best_idx = int(np.nanargmax(results['dqe']))
+    ax5.axvline(results['thickness_um'][best_idx], color='g', linestyle='--', alpha=0.7, linewidth=2)
+
+# Plot 6: its two factors
+ax6 = axes[1, 2]
+ax6.plot(results['thickness_um'], results['absorption'], 'c-o', linewidth=2, markersize=6, label='Absorption fraction')
+ax6.errorbar(results['thickness_um'], results['swank'], yerr=results['swank_err'],
+             fmt='y-o', linewidth=2, markersize=6, capsize=3, label='Swank factor')
+ax6.set_xlabel('CsI Thickness (μm)', fontsize=12)
+ax6.set_ylabel('Fraction', fontsize=12)
+ax6.set_title('DQE(0) = Absorption x Swank', fontsize=13)
+ax6.legend()
+ax6.grid(True, alpha=0.3)
+
 plt.tight_layout()
 plt.savefig('csi_thickness_optimization.png', dpi=300, bbox_inches='tight')
 print("Plot saved as 'csi_thickness_optimization.png'")
@@ -151,6 +191,11 @@ if results['electrons']:
     print(f"Optimal Thickness: {results['thickness_um'][optimal_idx]} μm")
     print(f"Maximum Photoelectrons: {results['electrons'][optimal_idx]:.1f}")
     print(f"Detection Efficiency at Optimal: {results['detection_efficiency'][optimal_idx]:.1f}%")
+    if np.any(np.isfinite(results['dqe'])):
+        best_idx = int(np.nanargmax(results['dqe']))
+        print(f"Optimal Thickness by DQE(0): {results['thickness_um'][best_idx]} μm "
+              f"(DQE(0) = {results['dqe'][best_idx]:.3f} +- {results['dqe_err'][best_idx]:.3f}, "
+              f"absorption {results['absorption'][best_idx]:.3f}, Swank {results['swank'][best_idx]:.3f})")
     
     # Show trend
     if len(results['electrons']) > 5: